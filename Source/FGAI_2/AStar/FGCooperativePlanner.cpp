@@ -0,0 +1,329 @@
+#include "FGCooperativePlanner.h"
+
+#include "Algo/Reverse.h"
+#include "FGAI_2/Grid/FGGridActor.h"
+
+bool FFGReservationTable::CanMove(int32 From, int32 To, int32 Time, int32 AgentId) const
+{
+	if (!IsFree(To, Time + 1, AgentId))
+		return false;
+
+	if (From == To)
+		return true;
+
+	const int32 Other = GetOwner(To, Time);
+	return Other == INDEX_NONE || Other == AgentId || GetOwner(From, Time + 1) != Other;
+}
+
+void FFGReservationTable::Release(int32 Tile, int32 Time, int32 AgentId)
+{
+	const uint64 Key = MakeKey(Tile, Time);
+	const int32* Owner = Reservations.Find(Key);
+	if (Owner != nullptr && *Owner == AgentId)
+		Reservations.Remove(Key);
+}
+
+void FFGReservationTable::RemoveBefore(int32 Time)
+{
+	for (auto It = Reservations.CreateIterator(); It; ++It)
+	{
+		if (static_cast<int32>(It.Key() >> 32) < Time)
+			It.RemoveCurrent();
+	}
+}
+
+FFGCooperativePlanner::~FFGCooperativePlanner()
+{
+	Reset();
+}
+
+void FFGCooperativePlanner::Initialize(AFGGridActor* InGrid, int32 InWindow)
+{
+	Reset();
+
+	if (InGrid == nullptr)
+		return;
+
+	Grid = InGrid;
+	TilesChangedHandle = InGrid->OnTilesChanged.AddRaw(this, &FFGCooperativePlanner::HandleTilesChanged);
+	Window = FMath::Max(InWindow, 2);
+
+	if (!InGrid->PathGrid.ObstacleGrid.IsValid())
+		InGrid->RebuildObstacleGrid();
+}
+
+void FFGCooperativePlanner::Reset()
+{
+	if (Grid.IsValid() && TilesChangedHandle.IsValid())
+	{
+		Grid->OnTilesChanged.Remove(TilesChangedHandle);
+	}
+	TilesChangedHandle.Reset();
+	Grid.Reset();
+
+	Agents.Empty();
+	Reservations.Reset();
+	AbstractDistances.Reset();
+	CurrentTime = 0;
+}
+
+int32 FFGCooperativePlanner::AddAgent(int32 StartTile, int32 GoalTile)
+{
+	if (!Grid.IsValid() || !Grid->IsTileIndexValid(StartTile) || !Grid->IsTileIndexValid(GoalTile))
+		return INDEX_NONE;
+
+	FAgent NewAgent;
+	NewAgent.Tile = StartTile;
+	NewAgent.Goal = GoalTile;
+	const int32 AgentId = Agents.Add(MoveTemp(NewAgent));
+
+	PlanAgent(AgentId);
+	return AgentId;
+}
+
+void FFGCooperativePlanner::RemoveAgent(int32 AgentId)
+{
+	if (!Agents.IsValidIndex(AgentId))
+		return;
+
+	ReleasePlan(AgentId);
+	Agents.RemoveAt(AgentId);
+}
+
+void FFGCooperativePlanner::SetGoal(int32 AgentId, int32 GoalTile)
+{
+	if (!Agents.IsValidIndex(AgentId) || !Grid.IsValid() || !Grid->IsTileIndexValid(GoalTile))
+		return;
+
+	Agents[AgentId].Goal = GoalTile;
+	PlanAgent(AgentId);
+}
+
+void FFGCooperativePlanner::Step()
+{
+	if (!Grid.IsValid())
+		return;
+
+	++CurrentTime;
+
+	for (auto It = Agents.CreateIterator(); It; ++It)
+	{
+		FAgent& Agent = *It;
+		const int32 PlanIdx = CurrentTime - Agent.PlanStartTime;
+		if (Agent.Plan.IsValidIndex(PlanIdx))
+			Agent.Tile = Agent.Plan[PlanIdx];
+	}
+
+	if (CurrentTime % Window == 0)
+		Reservations.RemoveBefore(CurrentTime);
+
+	// Replanning in id order gives earlier agents priority, same as when they were added
+	const int32 ReplanInterval = FMath::Max(1, Window / 2);
+	for (auto It = Agents.CreateIterator(); It; ++It)
+	{
+		const int32 PlanIdx = CurrentTime - It->PlanStartTime;
+		if (bReplanAll || PlanIdx >= ReplanInterval || PlanIdx >= It->Plan.Num() - 1)
+			PlanAgent(It.GetIndex());
+	}
+	bReplanAll = false;
+}
+
+int32 FFGCooperativePlanner::GetAgentTile(int32 AgentId) const
+{
+	return Agents.IsValidIndex(AgentId) ? Agents[AgentId].Tile : INDEX_NONE;
+}
+
+bool FFGCooperativePlanner::GetAgentPlan(int32 AgentId, TArray<int32>& OutPlan) const
+{
+	OutPlan.Reset();
+	if (!Agents.IsValidIndex(AgentId))
+		return false;
+
+	const FAgent& Agent = Agents[AgentId];
+	for (int32 PlanIdx = FMath::Max(0, CurrentTime - Agent.PlanStartTime); PlanIdx < Agent.Plan.Num(); ++PlanIdx)
+	{
+		OutPlan.Add(Agent.Plan[PlanIdx]);
+	}
+	return OutPlan.Num() > 0;
+}
+
+void FFGCooperativePlanner::PlanAgent(int32 AgentId)
+{
+	FAgent& Agent = Agents[AgentId];
+	ReleasePlan(AgentId);
+
+	Agent.PlanStartTime = CurrentTime;
+	Agent.Plan.Reset();
+
+	const TArray<int32>& Distances = GetAbstractDistances(Agent.Goal);
+	const FFGObstacleGrid& Obstacles = Grid->PathGrid.ObstacleGrid;
+	const int32 NumTiles = Grid->GetNumTiles();
+	const int32 Width = Grid->Width;
+	const int32 WindowEnd = CurrentTime + Window;
+
+	Nodes.Reset();
+	OpenHeap.Reset();
+
+	int64 BestKey = -1;
+	if (Distances[Agent.Tile] != INDEX_NONE)
+	{
+		const int64 StartKey = Agent.Tile;
+		Nodes.Add(StartKey, FSpaceTimeNode());
+		OpenHeap.HeapPush(FOpenEntry{Distances[Agent.Tile], 0, StartKey});
+
+		while (OpenHeap.Num() > 0)
+		{
+			FOpenEntry Current;
+			OpenHeap.HeapPop(Current);
+
+			FSpaceTimeNode& CurrentNode = Nodes.FindChecked(Current.Key);
+			if (CurrentNode.bClosed || CurrentNode.GScore != Current.GScore)
+				continue;
+			CurrentNode.bClosed = true;
+
+			const int32 Depth = static_cast<int32>(Current.Key / NumTiles);
+			const int32 Tile = static_cast<int32>(Current.Key % NumTiles);
+			const int32 Time = CurrentTime + Depth;
+
+			if (Depth == Window || (Tile == Agent.Goal && IsGoalFreeUntilWindowEnd(Tile, Time, WindowEnd, AgentId)))
+			{
+				BestKey = Current.Key;
+				break;
+			}
+
+			const int32 X = Tile % Width;
+			const int32 Y = Tile / Width;
+
+			//wait, north, south, west, east
+			static const int32 Offsets[5][2] = {{0, 0}, {0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+			for (int i = 0; i < 5; ++i)
+			{
+				const int32 NextX = X + Offsets[i][0];
+				const int32 NextY = Y + Offsets[i][1];
+				if (Obstacles.IsBlocked(NextX, NextY))
+					continue;
+
+				const int32 Next = NextY * Width + NextX;
+				if (Distances[Next] == INDEX_NONE || !Reservations.CanMove(Tile, Next, Time, AgentId))
+					continue;
+
+				// Standing on the goal is free, everything else costs a step
+				const int32 NewGScore = Current.GScore + ((Next == Tile && Tile == Agent.Goal) ? 0 : 1);
+				const int64 NextKey = static_cast<int64>(Depth + 1) * NumTiles + Next;
+
+				FSpaceTimeNode* NextNode = Nodes.Find(NextKey);
+				if (NextNode == nullptr)
+				{
+					NextNode = &Nodes.Add(NextKey, FSpaceTimeNode());
+				}
+				else if (NextNode->bClosed || NewGScore >= NextNode->GScore)
+				{
+					continue;
+				}
+
+				NextNode->GScore = NewGScore;
+				NextNode->Parent = Current.Key;
+				OpenHeap.HeapPush(FOpenEntry{NewGScore + Distances[Next], NewGScore, NextKey});
+			}
+		}
+	}
+
+	if (BestKey == -1)
+	{
+		// boxed in or the goal can't be reached at all, wait and try again next step
+		Agent.Plan.Add(Agent.Tile);
+	}
+	else
+	{
+		for (int64 Key = BestKey; Key != -1; Key = Nodes.FindChecked(Key).Parent)
+		{
+			Agent.Plan.Add(static_cast<int32>(Key % NumTiles));
+		}
+		Algo::Reverse(Agent.Plan);
+
+		// got to the goal before the window ran out, IsGoalFreeUntilWindowEnd made sure we can stay there
+		while (Agent.Plan.Num() < Window + 1)
+		{
+			Agent.Plan.Add(Agent.Goal);
+		}
+	}
+
+	for (int32 PlanIdx = 0; PlanIdx < Agent.Plan.Num(); ++PlanIdx)
+	{
+		if (Reservations.IsFree(Agent.Plan[PlanIdx], Agent.PlanStartTime + PlanIdx, AgentId))
+			Reservations.Reserve(Agent.Plan[PlanIdx], Agent.PlanStartTime + PlanIdx, AgentId);
+	}
+}
+
+void FFGCooperativePlanner::ReleasePlan(int32 AgentId)
+{
+	const FAgent& Agent = Agents[AgentId];
+	for (int32 PlanIdx = 0; PlanIdx < Agent.Plan.Num(); ++PlanIdx)
+	{
+		Reservations.Release(Agent.Plan[PlanIdx], Agent.PlanStartTime + PlanIdx, AgentId);
+	}
+}
+
+bool FFGCooperativePlanner::IsGoalFreeUntilWindowEnd(int32 Goal, int32 Time, int32 WindowEnd, int32 AgentId) const
+{
+	for (int32 T = Time; T <= WindowEnd; ++T)
+	{
+		if (!Reservations.IsFree(Goal, T, AgentId))
+			return false;
+	}
+	return true;
+}
+
+const TArray<int32>& FFGCooperativePlanner::GetAbstractDistances(int32 Goal)
+{
+	if (const TArray<int32>* Cached = AbstractDistances.Find(Goal))
+		return *Cached;
+
+	if (AbstractDistances.Num() >= MaxCachedGoals)
+		AbstractDistances.Reset();
+
+	const FFGObstacleGrid& Obstacles = Grid->PathGrid.ObstacleGrid;
+	const int32 Width = Grid->Width;
+
+	TArray<int32>& Distances = AbstractDistances.Add(Goal);
+	Distances.Init(INDEX_NONE, Grid->GetNumTiles());
+
+	if (Obstacles.IsBlocked(Goal))
+		return Distances;
+
+	// Unit costs, so a breadth first flood out from the goal gives exact distances
+	FloodQueue.Reset();
+	FloodQueue.Add(Goal);
+	Distances[Goal] = 0;
+
+	for (int32 Head = 0; Head < FloodQueue.Num(); ++Head)
+	{
+		const int32 Tile = FloodQueue[Head];
+		const int32 X = Tile % Width;
+		const int32 Y = Tile / Width;
+
+		static const int32 Offsets[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+		for (int i = 0; i < 4; ++i)
+		{
+			const int32 NextX = X + Offsets[i][0];
+			const int32 NextY = Y + Offsets[i][1];
+			if (Obstacles.IsBlocked(NextX, NextY))
+				continue;
+
+			const int32 Next = NextY * Width + NextX;
+			if (Distances[Next] != INDEX_NONE)
+				continue;
+
+			Distances[Next] = Distances[Tile] + 1;
+			FloodQueue.Add(Next);
+		}
+	}
+
+	return Distances;
+}
+
+void FFGCooperativePlanner::HandleTilesChanged(const TArray<int32>& ChangedTiles)
+{
+	AbstractDistances.Reset();
+	bReplanAll = true;
+}
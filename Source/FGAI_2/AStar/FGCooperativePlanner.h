@@ -0,0 +1,144 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class AFGGridActor;
+
+/*
+* Who stands on which tile at which timestep. Keys pack (tile, time) into one uint64.
+*/
+struct FGAI_2_API FFGReservationTable
+{
+	static uint64 MakeKey(int32 Tile, int32 Time)
+	{
+		return (static_cast<uint64>(static_cast<uint32>(Time)) << 32) | static_cast<uint32>(Tile);
+	}
+
+	int32 GetOwner(int32 Tile, int32 Time) const
+	{
+		const int32* Owner = Reservations.Find(MakeKey(Tile, Time));
+		return Owner != nullptr ? *Owner : INDEX_NONE;
+	}
+
+	bool IsFree(int32 Tile, int32 Time, int32 AgentId) const
+	{
+		const int32 Owner = GetOwner(Tile, Time);
+		return Owner == INDEX_NONE || Owner == AgentId;
+	}
+
+	/*
+	* Moving From->To between Time and Time+1. Also rejects swapping places with another agent head on.
+	*/
+	bool CanMove(int32 From, int32 To, int32 Time, int32 AgentId) const;
+
+	void Reserve(int32 Tile, int32 Time, int32 AgentId) { Reservations.Add(MakeKey(Tile, Time), AgentId); }
+	void Release(int32 Tile, int32 Time, int32 AgentId);
+
+	/*
+	* Drops everything older than Time, nobody can collide in the past.
+	*/
+	void RemoveBefore(int32 Time);
+
+	void Reset() { Reservations.Reset(); }
+
+	TMap<uint64, int32> Reservations;
+};
+
+/*
+* Windowed Hierarchical Cooperative A* over a grid, 4-connected plus waiting.
+* Agents plan Window steps ahead in space-time around each other's reservations. Past the window
+* the true distance to the goal ignoring other agents takes over as heuristic, one backwards flood per goal
+* shared by every agent heading there. Agents replan every Window / 2 steps so the cost stays bounded.
+*/
+class FGAI_2_API FFGCooperativePlanner
+{
+public:
+	FFGCooperativePlanner() = default;
+	~FFGCooperativePlanner();
+
+	FFGCooperativePlanner(const FFGCooperativePlanner&) = delete;
+	FFGCooperativePlanner& operator=(const FFGCooperativePlanner&) = delete;
+
+	void Initialize(AFGGridActor* InGrid, int32 InWindow = 16);
+	void Reset();
+
+	/*
+	* Returns the agent id, plans right away so it is reserved before the next agent gets added.
+	*/
+	int32 AddAgent(int32 StartTile, int32 GoalTile);
+	void RemoveAgent(int32 AgentId);
+	void SetGoal(int32 AgentId, int32 GoalTile);
+
+	/*
+	* Advances every agent one timestep along its plan and replans the ones that used up half their window.
+	*/
+	void Step();
+
+	int32 GetAgentTile(int32 AgentId) const;
+
+	/*
+	* Remaining tiles of the agent's current plan, one per timestep starting at the current one.
+	*/
+	bool GetAgentPlan(int32 AgentId, TArray<int32>& OutPlan) const;
+
+	int32 GetCurrentTime() const { return CurrentTime; }
+	int32 GetWindow() const { return Window; }
+
+private:
+	struct FAgent
+	{
+		int32 Tile = -1;
+		int32 Goal = -1;
+		int32 PlanStartTime = 0;
+		TArray<int32> Plan;
+	};
+
+	struct FSpaceTimeNode
+	{
+		int32 GScore = 0;
+		int64 Parent = -1;
+		bool bClosed = false;
+	};
+
+	struct FOpenEntry
+	{
+		int32 FScore;
+		int32 GScore;
+		int64 Key;
+
+		bool operator<(const FOpenEntry& Other) const
+		{
+			// on ties prefer the higher GScore, less of the estimate is left so the node is nearer the goal
+			return FScore < Other.FScore || (FScore == Other.FScore && GScore > Other.GScore);
+		}
+	};
+
+	void PlanAgent(int32 AgentId);
+	void ReleasePlan(int32 AgentId);
+	bool IsGoalFreeUntilWindowEnd(int32 Goal, int32 Time, int32 WindowEnd, int32 AgentId) const;
+
+	const TArray<int32>& GetAbstractDistances(int32 Goal);
+	void HandleTilesChanged(const TArray<int32>& ChangedTiles);
+
+	TWeakObjectPtr<AFGGridActor> Grid;
+	FDelegateHandle TilesChangedHandle;
+
+	int32 Window = 16;
+	int32 CurrentTime = 0;
+	bool bReplanAll = false;
+
+	TSparseArray<FAgent> Agents;
+	FFGReservationTable Reservations;
+
+	/*
+	* Goal tile -> distance of every tile to it ignoring agents, INDEX_NONE where it can't be reached.
+	*/
+	TMap<int32, TArray<int32>> AbstractDistances;
+	int32 MaxCachedGoals = 64;
+
+	// reused between searches, space-time keys are Depth * NumTiles + Tile
+	TMap<int64, FSpaceTimeNode> Nodes;
+	TArray<FOpenEntry> OpenHeap;
+	TArray<int32> FloodQueue;
+};
@@ -0,0 +1,304 @@
+#include "FGDStarLite.h"
+
+#include "FGAI_2/Grid/FGGridActor.h"
+
+constexpr int32 FFGDStarLite::Infinity;
+
+FFGDStarLite::~FFGDStarLite()
+{
+	Reset();
+}
+
+void FFGDStarLite::Initialize(AFGGridActor* InGrid, int32 InStart, int32 InGoal)
+{
+	Reset();
+
+	if (InGrid == nullptr || !InGrid->IsTileIndexValid(InStart) || !InGrid->IsTileIndexValid(InGoal))
+		return;
+
+	Grid = InGrid;
+	TilesChangedHandle = InGrid->OnTilesChanged.AddRaw(this, &FFGDStarLite::HandleTilesChanged);
+
+	Width = InGrid->Width;
+	Start = InStart;
+	Goal = InGoal;
+	LastStart = InStart;
+	KeyModifier = 0;
+
+	const int32 NumTiles = InGrid->GetNumTiles();
+	G.Init(Infinity, NumTiles);
+	Rhs.Init(Infinity, NumTiles);
+	QueuedKeys.SetNum(NumTiles);
+	InQueue.Init(false, NumTiles);
+
+	Rhs[Goal] = 0;
+	QueueInsert(Goal, CalculateKey(Goal));
+}
+
+void FFGDStarLite::Reset()
+{
+	if (Grid.IsValid() && TilesChangedHandle.IsValid())
+	{
+		Grid->OnTilesChanged.Remove(TilesChangedHandle);
+	}
+	TilesChangedHandle.Reset();
+	Grid.Reset();
+
+	G.Reset();
+	Rhs.Reset();
+	Queue.Reset();
+	QueuedKeys.Reset();
+	InQueue.Empty();
+	PendingChanges.Reset();
+	Start = Goal = LastStart = -1;
+}
+
+void FFGDStarLite::MoveStart(int32 NewStart)
+{
+	if (G.IsValidIndex(NewStart))
+		Start = NewStart;
+}
+
+bool FFGDStarLite::Replan()
+{
+	LastExpansionCount = 0;
+
+	if (!Grid.IsValid() || G.Num() == 0)
+		return false;
+
+	// Resized grids can't be repaired, the tile indices don't mean the same thing anymore
+	if (Grid->GetNumTiles() != G.Num() || Grid->Width != Width)
+	{
+		Initialize(Grid.Get(), FMath::Min(Start, Grid->GetNumTiles() - 1), FMath::Min(Goal, Grid->GetNumTiles() - 1));
+		if (G.Num() == 0)
+			return false;
+	}
+
+	if (PendingChanges.Num() > 0)
+	{
+		KeyModifier += Heuristic(LastStart, Start);
+		LastStart = Start;
+
+		for (const int32 Changed : PendingChanges)
+		{
+			int32 Neighbors[4];
+			const int32 NumNeighbors = GetNeighbors(Changed, Neighbors);
+
+			// Every edge touching the changed tile got a new cost, recompute rhs on both ends
+			if (Changed != Goal)
+			{
+				Rhs[Changed] = MinSuccessorCost(Changed);
+				UpdateVertex(Changed);
+			}
+
+			for (int32 i = 0; i < NumNeighbors; ++i)
+			{
+				if (Neighbors[i] == Goal)
+					continue;
+
+				Rhs[Neighbors[i]] = MinSuccessorCost(Neighbors[i]);
+				UpdateVertex(Neighbors[i]);
+			}
+		}
+		PendingChanges.Reset();
+	}
+
+	return ComputeShortestPath();
+}
+
+bool FFGDStarLite::GetPath(TArray<int32>& OutPath) const
+{
+	OutPath.Reset();
+
+	if (!G.IsValidIndex(Start) || G[Start] == Infinity)
+		return false;
+
+	int32 Current = Start;
+	OutPath.Add(Current);
+
+	while (Current != Goal)
+	{
+		int32 Neighbors[4];
+		const int32 NumNeighbors = GetNeighbors(Current, Neighbors);
+
+		int32 Best = -1;
+		int32 BestCost = Infinity;
+		for (int32 i = 0; i < NumNeighbors; ++i)
+		{
+			const int32 NeighborCost = AddCost(Cost(Current, Neighbors[i]), G[Neighbors[i]]);
+			if (NeighborCost < BestCost)
+			{
+				BestCost = NeighborCost;
+				Best = Neighbors[i];
+			}
+		}
+
+		// Either unreachable or the search is out of date, don't loop forever in both cases
+		if (Best == -1 || OutPath.Num() > G.Num())
+		{
+			OutPath.Reset();
+			return false;
+		}
+
+		Current = Best;
+		OutPath.Add(Current);
+	}
+
+	return true;
+}
+
+bool FFGDStarLite::IsBlocked(int32 Tile) const
+{
+	return Grid->TileList[Tile].bBlock;
+}
+
+int32 FFGDStarLite::Cost(int32 From, int32 To) const
+{
+	return (IsBlocked(From) || IsBlocked(To)) ? Infinity : 1;
+}
+
+int32 FFGDStarLite::Heuristic(int32 A, int32 B) const
+{
+	const int32 AX = A % Width, AY = A / Width;
+	const int32 BX = B % Width, BY = B / Width;
+	return FMath::Abs(AX - BX) + FMath::Abs(AY - BY);
+}
+
+int32 FFGDStarLite::GetNeighbors(int32 Tile, int32 OutNeighbors[4]) const
+{
+	const int32 X = Tile % Width;
+	const int32 Y = Tile / Width;
+	const int32 Height = G.Num() / Width;
+
+	int32 Num = 0;
+	if (Y > 0)
+		OutNeighbors[Num++] = Tile - Width;
+	if (Y < Height - 1)
+		OutNeighbors[Num++] = Tile + Width;
+	if (X > 0)
+		OutNeighbors[Num++] = Tile - 1;
+	if (X < Width - 1)
+		OutNeighbors[Num++] = Tile + 1;
+	return Num;
+}
+
+FFGDStarLite::FKey FFGDStarLite::CalculateKey(int32 Tile) const
+{
+	const int32 Min = FMath::Min(G[Tile], Rhs[Tile]);
+	return FKey{AddCost(AddCost(Min, Heuristic(Start, Tile)), KeyModifier), Min};
+}
+
+void FFGDStarLite::UpdateVertex(int32 Tile)
+{
+	if (G[Tile] != Rhs[Tile])
+		QueueInsert(Tile, CalculateKey(Tile));
+	else
+		QueueRemove(Tile);
+}
+
+int32 FFGDStarLite::MinSuccessorCost(int32 Tile) const
+{
+	int32 Neighbors[4];
+	const int32 NumNeighbors = GetNeighbors(Tile, Neighbors);
+
+	int32 Result = Infinity;
+	for (int32 i = 0; i < NumNeighbors; ++i)
+	{
+		Result = FMath::Min(Result, AddCost(Cost(Tile, Neighbors[i]), G[Neighbors[i]]));
+	}
+	return Result;
+}
+
+void FFGDStarLite::QueueInsert(int32 Tile, const FKey& Key)
+{
+	if (InQueue[Tile] && QueuedKeys[Tile] == Key)
+		return;
+
+	InQueue[Tile] = true;
+	QueuedKeys[Tile] = Key;
+	Queue.HeapPush(FQueueEntry{Key, Tile});
+}
+
+void FFGDStarLite::QueueRemove(int32 Tile)
+{
+	InQueue[Tile] = false;
+}
+
+bool FFGDStarLite::QueueTop(FQueueEntry& OutTop)
+{
+	while (Queue.Num() > 0)
+	{
+		const FQueueEntry& Top = Queue.HeapTop();
+		if (InQueue[Top.Tile] && QueuedKeys[Top.Tile] == Top.Key)
+		{
+			OutTop = Top;
+			return true;
+		}
+		Queue.HeapPopDiscard();
+	}
+	return false;
+}
+
+bool FFGDStarLite::ComputeShortestPath()
+{
+	FQueueEntry Top;
+	while (QueueTop(Top))
+	{
+		if (!(Top.Key < CalculateKey(Start)) && Rhs[Start] == G[Start])
+			break;
+
+		const int32 Tile = Top.Tile;
+		Queue.HeapPopDiscard();
+		InQueue[Tile] = false;
+		++LastExpansionCount;
+
+		const FKey NewKey = CalculateKey(Tile);
+
+		int32 Neighbors[4];
+		const int32 NumNeighbors = GetNeighbors(Tile, Neighbors);
+
+		if (Top.Key < NewKey)
+		{
+			QueueInsert(Tile, NewKey);
+		}
+		else if (G[Tile] > Rhs[Tile])
+		{
+			G[Tile] = Rhs[Tile];
+			for (int32 i = 0; i < NumNeighbors; ++i)
+			{
+				const int32 Pred = Neighbors[i];
+				if (Pred == Goal)
+					continue;
+
+				Rhs[Pred] = FMath::Min(Rhs[Pred], AddCost(Cost(Pred, Tile), G[Tile]));
+				UpdateVertex(Pred);
+			}
+		}
+		else
+		{
+			const int32 OldG = G[Tile];
+			G[Tile] = Infinity;
+			for (int32 i = 0; i < NumNeighbors; ++i)
+			{
+				const int32 Pred = Neighbors[i];
+				if (Pred == Goal)
+					continue;
+
+				if (Rhs[Pred] == AddCost(Cost(Pred, Tile), OldG))
+					Rhs[Pred] = MinSuccessorCost(Pred);
+				UpdateVertex(Pred);
+			}
+
+			if (Tile != Goal)
+				Rhs[Tile] = MinSuccessorCost(Tile);
+			UpdateVertex(Tile);
+		}
+	}
+
+	return G[Start] != Infinity;
+}
+
+void FFGDStarLite::HandleTilesChanged(const TArray<int32>& ChangedTiles)
+{
+	PendingChanges.Append(ChangedTiles);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class AFGGridActor;
+
+/*
+* D* Lite incremental planner over the TileList of one grid, 4-connected with unit costs like FindPath.
+* One instance per agent. The search runs from the goal towards the agent so moving the agent is cheap,
+* and tiles reported by AFGGridActor::OnTilesChanged only repair the part of the search they touch.
+*/
+class FGAI_2_API FFGDStarLite
+{
+public:
+	FFGDStarLite() = default;
+	~FFGDStarLite();
+
+	FFGDStarLite(const FFGDStarLite&) = delete;
+	FFGDStarLite& operator=(const FFGDStarLite&) = delete;
+
+	/*
+	* Resets all search state and subscribes to the grid's tile changes. Call Replan afterwards.
+	*/
+	void Initialize(AFGGridActor* InGrid, int32 InStart, int32 InGoal);
+
+	void Reset();
+
+	/*
+	* Call when the agent has advanced to another tile, usually the next one of the last path.
+	*/
+	void MoveStart(int32 NewStart);
+
+	/*
+	* Applies pending tile changes and repairs the search. Returns false if the goal can't be reached.
+	*/
+	bool Replan();
+
+	/*
+	* Follows the cheapest successors from start to goal, start first. Only valid after Replan returned true.
+	*/
+	bool GetPath(TArray<int32>& OutPath) const;
+
+	bool IsInitialized() const { return Grid.IsValid() && G.Num() > 0; }
+	int32 GetStart() const { return Start; }
+	int32 GetGoal() const { return Goal; }
+
+	/*
+	* Number of tiles expanded by the last Replan, handy to see that repairs stay local.
+	*/
+	int32 GetLastExpansionCount() const { return LastExpansionCount; }
+
+private:
+	struct FKey
+	{
+		int32 K1 = 0;
+		int32 K2 = 0;
+
+		bool operator<(const FKey& Other) const
+		{
+			return K1 < Other.K1 || (K1 == Other.K1 && K2 < Other.K2);
+		}
+
+		bool operator==(const FKey& Other) const
+		{
+			return K1 == Other.K1 && K2 == Other.K2;
+		}
+	};
+
+	struct FQueueEntry
+	{
+		FKey Key;
+		int32 Tile = -1;
+
+		bool operator<(const FQueueEntry& Other) const
+		{
+			return Key < Other.Key;
+		}
+	};
+
+	static constexpr int32 Infinity = MAX_int32;
+
+	static int32 AddCost(int32 A, int32 B)
+	{
+		return (A == Infinity || B == Infinity) ? Infinity : A + B;
+	}
+
+	bool IsBlocked(int32 Tile) const;
+	int32 Cost(int32 From, int32 To) const;
+	int32 Heuristic(int32 A, int32 B) const;
+	int32 GetNeighbors(int32 Tile, int32 OutNeighbors[4]) const;
+
+	FKey CalculateKey(int32 Tile) const;
+	void UpdateVertex(int32 Tile);
+	int32 MinSuccessorCost(int32 Tile) const;
+
+	void QueueInsert(int32 Tile, const FKey& Key);
+	void QueueRemove(int32 Tile);
+	bool QueueTop(FQueueEntry& OutTop);
+
+	bool ComputeShortestPath();
+	void HandleTilesChanged(const TArray<int32>& ChangedTiles);
+
+	TWeakObjectPtr<AFGGridActor> Grid;
+	FDelegateHandle TilesChangedHandle;
+
+	int32 Width = 0;
+	int32 Start = -1;
+	int32 Goal = -1;
+	int32 LastStart = -1;
+	int32 KeyModifier = 0;
+	int32 LastExpansionCount = 0;
+
+	TArray<int32> G;
+	TArray<int32> Rhs;
+
+	/*
+	* Binary heap with lazy removal. An entry is only live if its tile is still flagged InQueue
+	* and the key matches QueuedKeys, everything else is skipped when it reaches the top.
+	*/
+	TArray<FQueueEntry> Queue;
+	TArray<FKey> QueuedKeys;
+	TBitArray<> InQueue;
+
+	TArray<int32> PendingChanges;
+};
@@ -0,0 +1,444 @@
+#include "FGPathBenchmarkCommandlet.h"
+
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "FGAI_2/Grid/FGGridActor.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+	struct FFGBenchmarkSettings
+	{
+		int32 NumSamples = 30;
+		int32 NumWarmup = 5;
+		double MinSampleSeconds = 0.002;
+		FString Filter;
+	};
+
+	/*
+	* Times are nanoseconds per operation.
+	*/
+	struct FFGBenchmarkResult
+	{
+		FString Name;
+		int32 OpsPerSample = 0;
+		double Median = 0.0;
+		double Mean = 0.0;
+		double StdDev = 0.0;
+		double Min = 0.0;
+		double P95 = 0.0;
+		// median absolute deviation, the baseline comparison takes it as the noise of a run
+		double Mad = 0.0;
+		// sum of whatever the operations returned, keeps the optimizer from throwing the work away
+		int64 Checksum = 0;
+	};
+
+	double Median(const TArray<double>& Sorted)
+	{
+		const int32 Mid = Sorted.Num() / 2;
+		return (Sorted.Num() % 2) == 1 ? Sorted[Mid] : 0.5 * (Sorted[Mid - 1] + Sorted[Mid]);
+	}
+
+	// nearest rank
+	double Percentile(const TArray<double>& Sorted, double Fraction)
+	{
+		const int32 Rank = FMath::Clamp(FMath::CeilToInt(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+		return Sorted[Rank];
+	}
+
+	/*
+	* Body(NumOps) does NumOps operations and returns something that depends on all of them.
+	* The batch size doubles until one batch takes MinSampleSeconds, then come the warm-up batches and the samples.
+	*/
+	template <typename BodyType>
+	void RunBenchmark(const TCHAR* Name, const FFGBenchmarkSettings& Settings, TArray<FFGBenchmarkResult>& OutResults,
+	                  BodyType&& Body)
+	{
+		if (!Settings.Filter.IsEmpty() && !FCString::Stristr(Name, *Settings.Filter))
+			return;
+
+		FFGBenchmarkResult Result;
+		Result.Name = Name;
+
+		auto TimeBatch = [&Result, &Body](int32 NumOps)-> double
+		{
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Result.Checksum += Body(NumOps);
+			return FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+		};
+
+		int32 OpsPerSample = 1;
+		while (TimeBatch(OpsPerSample) < Settings.MinSampleSeconds && OpsPerSample < (1 << 24))
+			OpsPerSample *= 2;
+
+		for (int32 Warmup = 0; Warmup < Settings.NumWarmup; ++Warmup)
+			TimeBatch(OpsPerSample);
+
+		TArray<double> Samples;
+		Samples.Reserve(Settings.NumSamples);
+		for (int32 Sample = 0; Sample < Settings.NumSamples; ++Sample)
+			Samples.Add(TimeBatch(OpsPerSample) * 1e9 / OpsPerSample);
+		Samples.Sort();
+
+		double Sum = 0.0;
+		for (const double Sample : Samples)
+			Sum += Sample;
+
+		Result.OpsPerSample = OpsPerSample;
+		Result.Median = Median(Samples);
+		Result.Mean = Sum / Samples.Num();
+		Result.Min = Samples[0];
+		Result.P95 = Percentile(Samples, 0.95);
+
+		double SquaredDiffs = 0.0;
+		TArray<double> Deviations;
+		for (const double Sample : Samples)
+		{
+			SquaredDiffs += FMath::Square(Sample - Result.Mean);
+			Deviations.Add(FMath::Abs(Sample - Result.Median));
+		}
+		Deviations.Sort();
+		Result.StdDev = Samples.Num() > 1 ? FMath::Sqrt(SquaredDiffs / (Samples.Num() - 1)) : 0.0;
+		Result.Mad = Median(Deviations);
+
+		UE_LOG(LogTemp, Display, TEXT("%-28s %12.1f ns/op  (mad %.1f, p95 %.1f, %d ops/sample)"),
+		       Name, Result.Median, Result.Mad, Result.P95, OpsPerSample);
+		OutResults.Add(MoveTemp(Result));
+	}
+
+	/*
+	* Names of the benchmarks that got slower than Threshold (a fraction) compared to the baseline file.
+	* Differences within three times the combined MAD of both runs count as noise.
+	*/
+	bool FindRegressions(const FString& BaselinePath, const TArray<FFGBenchmarkResult>& Results, double Threshold,
+	                     TArray<FString>& OutRegressions)
+	{
+		FString BaselineJson;
+		TSharedPtr<FJsonObject> Baseline;
+		if (!FFileHelper::LoadFileToString(BaselineJson, *BaselinePath)
+			|| !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineJson), Baseline) || !Baseline.IsValid())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Could not read benchmark baseline %s"), *BaselinePath);
+			return false;
+		}
+
+		TMap<FString, TSharedPtr<FJsonObject>> BaselineResults;
+		for (const TSharedPtr<FJsonValue>& Value : Baseline->GetArrayField(TEXT("Results")))
+		{
+			const TSharedPtr<FJsonObject> Entry = Value->AsObject();
+			if (Entry.IsValid())
+				BaselineResults.Add(Entry->GetStringField(TEXT("Name")), Entry);
+		}
+
+		for (const FFGBenchmarkResult& Result : Results)
+		{
+			const TSharedPtr<FJsonObject>* Entry = BaselineResults.Find(Result.Name);
+			if (Entry == nullptr)
+				continue;
+
+			const double BaseMedian = (*Entry)->GetNumberField(TEXT("MedianNs"));
+			const double BaseMad = (*Entry)->GetNumberField(TEXT("MadNs"));
+			const double Change = BaseMedian > 0.0 ? (Result.Median - BaseMedian) / BaseMedian : 0.0;
+			const bool bRegressed = Change > Threshold && Result.Median - BaseMedian > 3.0 * (Result.Mad + BaseMad);
+
+			UE_LOG(LogTemp, Display, TEXT("%-28s %+7.1f%%%s"), *Result.Name, Change * 100.0,
+			       bRegressed ? TEXT("  REGRESSION") : TEXT(""));
+			if (bRegressed)
+				OutRegressions.Add(Result.Name);
+		}
+		return true;
+	}
+}
+
+UFGPathBenchmarkCommandlet::UFGPathBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UFGPathBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 Width = 256;
+	int32 Height = 256;
+	int32 Density = 20;
+	int32 Seed = 1;
+	int32 MinSampleMs = 2;
+	float ThresholdPercent = 10.0f;
+	FString OutputPath;
+	FString BaselinePath;
+	FFGBenchmarkSettings Settings;
+
+	FParse::Value(*Params, TEXT("Width="), Width);
+	FParse::Value(*Params, TEXT("Height="), Height);
+	FParse::Value(*Params, TEXT("Density="), Density);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Samples="), Settings.NumSamples);
+	FParse::Value(*Params, TEXT("Warmup="), Settings.NumWarmup);
+	FParse::Value(*Params, TEXT("MinSampleMs="), MinSampleMs);
+	FParse::Value(*Params, TEXT("Threshold="), ThresholdPercent);
+	FParse::Value(*Params, TEXT("Filter="), Settings.Filter);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("Baseline="), BaselinePath);
+
+	Width = FMath::Max(Width, 2);
+	Height = FMath::Max(Height, 2);
+	Settings.NumSamples = FMath::Max(Settings.NumSamples, 1);
+	Settings.MinSampleSeconds = FMath::Max(MinSampleMs, 1) * 0.001;
+
+	if (OutputPath.IsEmpty())
+	{
+		OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks")
+			/ FString::Printf(TEXT("FGPathBenchmark-%s.json"), *FDateTime::Now().ToString());
+	}
+
+	/*
+	* A throwaway world with one grid actor in it. Random obstacles, except the two corners the path
+	* benchmarks run between.
+	*/
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	AFGGridActor* Grid = World->SpawnActorDeferred<AFGGridActor>(AFGGridActor::StaticClass(), FTransform::Identity);
+	Grid->Width = Width;
+	Grid->Height = Height;
+	Grid->FinishSpawning(FTransform::Identity);
+
+	const int32 NumTiles = Grid->GetNumTiles();
+	FRandomStream Random(Seed);
+	for (int32 TileIndex = 0; TileIndex < NumTiles; ++TileIndex)
+	{
+		Grid->TileList[TileIndex].bBlock = Random.RandRange(0, 99) < Density;
+	}
+	Grid->TileList[0].bBlock = false;
+	Grid->TileList[NumTiles - 1].bBlock = false;
+
+	Grid->RebuildObstacleGrid();
+	Grid->RebuildComponentLabels();
+	Grid->JPSPreProcess();
+	FFGPathGrid& PathGrid = Grid->PathGrid;
+
+	// lookups go through a fixed table of random tiles, so the access pattern isn't a straight walk
+	constexpr int32 NumLookups = 4096;
+	TArray<int32> LookupTiles;
+	TArray<FIntPoint> LookupXYs;
+	for (int32 Index = 0; Index < NumLookups; ++Index)
+	{
+		const int32 TileIndex = Random.RandRange(0, NumTiles - 1);
+		LookupTiles.Add(TileIndex);
+		LookupXYs.Add(FIntPoint(TileIndex % Width, TileIndex / Width));
+	}
+
+	TArray<FFGBenchmarkResult> Results;
+
+#pragma region open_list
+	constexpr int32 QueueSize = 4096;
+	TArray<int32> Priorities;
+	for (int32 Index = 0; Index < QueueSize; ++Index)
+	{
+		Priorities.Add(Random.RandRange(0, 1 << 16));
+	}
+
+	PriorityQueue<int32> Queue;
+	Queue.Reserve(QueueSize);
+
+	// one push and one pop per op, the queue fills up to QueueSize and gets drained again
+	RunBenchmark(TEXT("PriorityQueue.PushPop"), Settings, Results, [&](int32 NumOps)-> int64
+	{
+		int64 Sum = 0;
+		for (int32 Done = 0; Done < NumOps;)
+		{
+			const int32 Batch = FMath::Min(QueueSize, NumOps - Done);
+			for (int32 Value = 0; Value < Batch; ++Value)
+				Queue.PrioritisedAdd(Value, Priorities[Value]);
+			for (int32 Value = 0; Value < Batch; ++Value)
+				Sum += Queue.PopFirst();
+			Done += Batch;
+		}
+		return Sum;
+	});
+
+	// lowers one priority of a full queue per op, by a random amount
+	TArray<int32> CurrentPriorities = Priorities;
+	Queue.Reset();
+	for (int32 Value = 0; Value < QueueSize; ++Value)
+	{
+		Queue.PrioritisedAdd(Value, CurrentPriorities[Value]);
+	}
+	int32 NextValue = 0;
+	RunBenchmark(TEXT("PriorityQueue.DecreaseKey"), Settings, Results, [&](int32 NumOps)-> int64
+	{
+		int64 Sum = 0;
+		for (int32 Op = 0; Op < NumOps; ++Op)
+		{
+			CurrentPriorities[NextValue] -= 1 + (Priorities[(NextValue + Op) % QueueSize] & 63);
+			Queue.UpdatePriority(NextValue, CurrentPriorities[NextValue]);
+			Sum += Queue.TopPriority();
+			NextValue = (NextValue + 1) % QueueSize;
+		}
+		return Sum;
+	});
+	Queue.Reset();
+#pragma endregion
+
+#pragma region tile_conversions
+	RunBenchmark(TEXT("Grid.GetTileIndexFromXY"), Settings, Results, [&](int32 NumOps)-> int64
+	{
+		int64 Sum = 0;
+		for (int32 Op = 0; Op < NumOps; ++Op)
+		{
+			const FIntPoint& XY = LookupXYs[Op % NumLookups];
+			int32 TileIndex = 0;
+			Grid->GetTileIndexFromXY(XY.X, XY.Y, TileIndex);
+			Sum += TileIndex;
+		}
+		return Sum;
+	});
+
+	RunBenchmark(TEXT("Grid.GetXYFromTileIndex"), Settings, Results, [&](int32 NumOps)-> int64
+	{
+		int64 Sum = 0;
+		for (int32 Op = 0; Op < NumOps; ++Op)
+		{
+			int32 X = 0, Y = 0;
+			Grid->GetXYFromTileIndex(X, Y, LookupTiles[Op % NumLookups]);
+			Sum += X + Y;
+		}
+		return Sum;
+	});
+
+	// a 3x3 tile box around a random tile per op
+	TArray<int32> OverlappingTiles;
+	const FVector BoxExtent(Grid->TileSize * 1.5f - 1.0f);
+	RunBenchmark(TEXT("Grid.GetOverlappingTiles"), Settings, Results, [&](int32 NumOps)-> int64
+	{
+		int64 Sum = 0;
+		for (int32 Op = 0; Op < NumOps; ++Op)
+		{
+			const FIntPoint& XY = LookupXYs[Op % NumLookups];
+			OverlappingTiles.Reset();
+			Grid->GetOverlappingTiles(Grid->GetWorldLocationFromXY(XY.X, XY.Y), BoxExtent, OverlappingTiles);
+			Sum += OverlappingTiles.Num();
+		}
+		return Sum;
+	});
+#pragma endregion
+
+#pragma region jps_preprocess
+	// one op is one pass over the whole grid, every pass finds what the one before it left
+	RunBenchmark(TEXT("JPS.PrimaryJumpPoints"), Settings, Results, [&](int32 NumOps)-> int64
+	{
+		for (int32 Op = 0; Op < NumOps; ++Op)
+			PathGrid.FindPrimaryJumpPoints();
+		return PathGrid.JumpTiles[NumTiles / 2].ApproachDirs[0];
+	});
+
+	RunBenchmark(TEXT("JPS.CardinalSweeps"), Settings, Results, [&](int32 NumOps)-> int64
+	{
+		for (int32 Op = 0; Op < NumOps; ++Op)
+			PathGrid.SweepCardinalJumps();
+		return PathGrid.JumpTiles[NumTiles / 2].DirectionValues[eDir::East];
+	});
+
+	RunBenchmark(TEXT("JPS.DiagonalSweeps"), Settings, Results, [&](int32 NumOps)-> int64
+	{
+		for (int32 Op = 0; Op < NumOps; ++Op)
+			PathGrid.SweepDiagonalJumps();
+		return PathGrid.JumpTiles[NumTiles / 2].DirectionValues[eDir::Southeast];
+	});
+
+	RunBenchmark(TEXT("JPS.PreProcess"), Settings, Results, [&](int32 NumOps)-> int64
+	{
+		for (int32 Op = 0; Op < NumOps; ++Op)
+			PathGrid.JPSPreProcess();
+		return PathGrid.JumpTiles[NumTiles / 2].DirectionValues[eDir::Northwest];
+	});
+#pragma endregion
+
+#pragma region construct_path
+	// corner to corner with the 4-connected A*, that's the longest path the grid is likely to have
+	FFGSearchScratch Scratch;
+	int32 PathLength = 0;
+	if (PathGrid.FindPath(0, NumTiles - 1, TArrayView<int32>(), PathLength, Scratch) == EFGPathStatus::Truncated)
+	{
+		TArray<int32> Path;
+		Path.SetNumUninitialized(PathLength);
+		RunBenchmark(TEXT("Path.ConstructPath"), Settings, Results, [&](int32 NumOps)-> int64
+		{
+			int64 Sum = 0;
+			for (int32 Op = 0; Op < NumOps; ++Op)
+			{
+				int32 Length = 0;
+				PathGrid.ConstructPath(Scratch.Parent, NumTiles - 1, Path, Length);
+				Sum += Length;
+			}
+			return Sum;
+		});
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No path between the grid corners, skipping Path.ConstructPath. Try a lower -Density"));
+	}
+#pragma endregion
+
+	World->DestroyWorld(false);
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("Version"), 1);
+	Root->SetStringField(TEXT("Time"), FDateTime::UtcNow().ToIso8601());
+	Root->SetStringField(TEXT("Platform"), ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+	Root->SetStringField(TEXT("Configuration"), LexToString(FApp::GetBuildConfiguration()));
+	Root->SetNumberField(TEXT("Width"), Width);
+	Root->SetNumberField(TEXT("Height"), Height);
+	Root->SetNumberField(TEXT("Density"), Density);
+	Root->SetNumberField(TEXT("Seed"), Seed);
+	Root->SetNumberField(TEXT("Samples"), Settings.NumSamples);
+	Root->SetNumberField(TEXT("Warmup"), Settings.NumWarmup);
+
+	TArray<TSharedPtr<FJsonValue>> ResultValues;
+	for (const FFGBenchmarkResult& Result : Results)
+	{
+		TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+		Entry->SetStringField(TEXT("Name"), Result.Name);
+		Entry->SetNumberField(TEXT("OpsPerSample"), Result.OpsPerSample);
+		Entry->SetNumberField(TEXT("MedianNs"), Result.Median);
+		Entry->SetNumberField(TEXT("MeanNs"), Result.Mean);
+		Entry->SetNumberField(TEXT("StdDevNs"), Result.StdDev);
+		Entry->SetNumberField(TEXT("MinNs"), Result.Min);
+		Entry->SetNumberField(TEXT("P95Ns"), Result.P95);
+		Entry->SetNumberField(TEXT("MadNs"), Result.Mad);
+		Entry->SetNumberField(TEXT("Checksum"), static_cast<double>(Result.Checksum));
+		ResultValues.Add(MakeShared<FJsonValueObject>(Entry));
+	}
+	Root->SetArrayField(TEXT("Results"), ResultValues);
+
+	FString Json;
+	FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Json));
+	if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not write benchmark results to %s"), *OutputPath);
+		return 1;
+	}
+	UE_LOG(LogTemp, Display, TEXT("Benchmark results written to %s"), *OutputPath);
+
+	if (BaselinePath.IsEmpty())
+		return 0;
+
+	TArray<FString> Regressions;
+	if (!FindRegressions(BaselinePath, Results, ThresholdPercent * 0.01, Regressions))
+		return 1;
+
+	if (Regressions.Num() > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%d benchmarks regressed against %s: %s"), Regressions.Num(), *BaselinePath,
+		       *FString::Join(Regressions, TEXT(", ")));
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "FGPathBenchmarkCommandlet.generated.h"
+
+/*
+* Times the pathfinding building blocks one at a time: open list operations, tile index conversions,
+* the JPS preprocessing passes, GetOverlappingTiles and ConstructPath.
+*
+* UE4Editor-Cmd FGAI_2.uproject -run=FGPathBenchmark [-Width=256 -Height=256 -Density=20 -Seed=1]
+*     [-Samples=30 -Warmup=5 -MinSampleMs=2] [-Filter=JPS] [-Output=Results.json] [-Baseline=Old.json -Threshold=10]
+*
+* Every sample runs a benchmark often enough to take MinSampleMs, so timer resolution doesn't matter,
+* and the numbers are per operation. Results go to a JSON file (Saved/Benchmarks by default).
+* With a baseline, benchmarks whose median got slower by more than Threshold percent and more than
+* the noise of both runs are listed, and the commandlet returns 1 so a build script can fail on it.
+*/
+UCLASS()
+class UFGPathBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UFGPathBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -2,14 +2,144 @@
 
 #include "DrawDebugHelpers.h"
 #include "FGGridBlockComponent.h"
+#include "FGGridSubsystem.h"
+#include "Async/ParallelFor.h"
 #include "Components/StaticMeshComponent.h"
 #include "StaticMeshDescription.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType.h"
-#include "FGAI_2/AStar/PriorityQueue.h"
 #include "Kismet/GameplayStatics.h"
+#include "Net/UnrealNetwork.h"
+#include "HAL/PlatformFilemanager.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "FGAI_2Core/FGObstacleImport.h"
+
+namespace
+{
+	/*
+	* WeightedJPS's successors. Jumps walk one way until something interesting: the goal, a tile outside a
+	* uniform patch, or a tile with a forced neighbor (the tile beside it is free but the one behind that is blocked).
+	* Pruning only holds where every free tile around costs the same, that's the plain grid case scaled up.
+	* At the start and on patch borders all eight directions get tried, same as WeightedAStar would.
+	*/
+	struct FFGWeightedJumpNeighborhood
+	{
+		const FFGPathGrid& Grid;
+		int32 Goal;
+
+		struct SearchDirs
+		{
+			int32 NumValidDirs;
+			eDir ValidDirs[8];
+		};
+
+		// by travel direction, in eDir order
+		static const SearchDirs PrunedDirLookup[9];
+
+		template <typename VisitType>
+		void ForEachSuccessor(int32 TileIndex, int32 ParentTile, VisitType&& Visit) const
+		{
+			const int32 Width = Grid.Width;
+			const int32 TileX = TileIndex % Width;
+			const int32 TileY = TileIndex / Width;
+
+			const SearchDirs* TryDirs = &PrunedDirLookup[eDir::Nil];
+			if (ParentTile != -1 && Grid.CostGrid.IsUniform(TileIndex))
+			{
+				const IVec2 TravelDirection = {
+					FMath::Clamp(TileX - ParentTile % Width, -1, 1),
+					FMath::Clamp(TileY - ParentTile / Width, -1, 1)
+				};
+				for (int i = 0; i < 8; ++i)
+				{
+					if (FFGPathGrid::Directions[i] == TravelDirection)
+					{
+						TryDirs = &PrunedDirLookup[i];
+						break;
+					}
+				}
+			}
+
+			for (int32 DirIdx = 0; DirIdx < TryDirs->NumValidDirs; ++DirIdx)
+			{
+				const IVec2 Dir = FFGPathGrid::Directions[TryDirs->ValidDirs[DirIdx]];
+				int32 JumpCost = 0;
+				const int32 Successor = Dir.IsDiagonal()
+					                        ? JumpDiagonal(TileX, TileY, Dir, JumpCost)
+					                        : JumpCardinal(TileX, TileY, Dir, JumpCost);
+				if (Successor != INDEX_NONE)
+					Visit(Successor, JumpCost);
+			}
+		}
+
+		// INDEX_NONE on a dead end, adds what the steps cost to InOutCost
+		int32 JumpCardinal(int32 X, int32 Y, IVec2 Dir, int32& InOutCost) const
+		{
+			const FFGObstacleGrid& Obstacles = Grid.ObstacleGrid;
+			const IVec2 Side = {Dir.y, Dir.x};
+			while (true)
+			{
+				X += Dir.x;
+				Y += Dir.y;
+				if (Obstacles.IsBlocked(X, Y))
+					return INDEX_NONE;
+
+				const int32 TileIdx = Y * Grid.Width + X;
+				InOutCost += CardinalStepCost * Grid.CostGrid.GetCost(TileIdx);
+				if (TileIdx == Goal || !Grid.CostGrid.IsUniform(TileIdx))
+					return TileIdx;
+
+				if ((!Obstacles.IsBlocked(X + Side.x, Y + Side.y) && Obstacles.IsBlocked(X - Dir.x + Side.x, Y - Dir.y + Side.y))
+					|| (!Obstacles.IsBlocked(X - Side.x, Y - Side.y) && Obstacles.IsBlocked(X - Dir.x - Side.x, Y - Dir.y - Side.y)))
+					return TileIdx;
+			}
+		}
+
+		// diagonal steps never cut corners, and stop wherever one of the two cardinal jumps finds something
+		int32 JumpDiagonal(int32 X, int32 Y, IVec2 Dir, int32& InOutCost) const
+		{
+			const FFGObstacleGrid& Obstacles = Grid.ObstacleGrid;
+			while (true)
+			{
+				if (Obstacles.IsBlocked(X + Dir.x, Y + Dir.y)
+					|| Obstacles.IsBlocked(X + Dir.x, Y) || Obstacles.IsBlocked(X, Y + Dir.y))
+					return INDEX_NONE;
+
+				X += Dir.x;
+				Y += Dir.y;
+				const int32 TileIdx = Y * Grid.Width + X;
+				InOutCost += DiagonalStepCost * Grid.CostGrid.GetCost(TileIdx);
+				if (TileIdx == Goal || !Grid.CostGrid.IsUniform(TileIdx))
+					return TileIdx;
+
+				int32 IgnoredCost = 0;
+				if (JumpCardinal(X, Y, IVec2{Dir.x, 0}, IgnoredCost) != INDEX_NONE
+					|| JumpCardinal(X, Y, IVec2{0, Dir.y}, IgnoredCost) != INDEX_NONE)
+					return TileIdx;
+			}
+		}
+	};
+
+	const FFGWeightedJumpNeighborhood::SearchDirs FFGWeightedJumpNeighborhood::PrunedDirLookup[9] = {
+		{5, {eDir::North, eDir::Northwest, eDir::Northeast, eDir::West, eDir::East}},
+		{5, {eDir::South, eDir::Southwest, eDir::Southeast, eDir::West, eDir::East}},
+		{5, {eDir::West, eDir::Northwest, eDir::Southwest, eDir::North, eDir::South}},
+		{5, {eDir::East, eDir::Northeast, eDir::Southeast, eDir::North, eDir::South}},
+		{3, {eDir::Northwest, eDir::North, eDir::West}},
+		{3, {eDir::Northeast, eDir::North, eDir::East}},
+		{3, {eDir::Southwest, eDir::South, eDir::West}},
+		{3, {eDir::Southeast, eDir::South, eDir::East}},
+		{8, {eDir::North, eDir::South, eDir::West, eDir::East, eDir::Northwest, eDir::Northeast, eDir::Southwest, eDir::Southeast}}
+	};
+}
 
 AFGGridActor::AFGGridActor()
 {
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
 
 	StaticMeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("StaticMeshComponent"));
@@ -19,18 +149,73 @@ AFGGridActor::AFGGridActor()
 	BlockStaticMeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("BlockStaticMeshComponent"));
 	BlockStaticMeshComponent->SetupAttachment(RootComponent);
 	BlockStaticMeshComponent->SetCastShadow(false);
+
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	ObstacleDeltas.Owner = this;
+}
+
+void AFGGridActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AFGGridActor, ObstacleDeltas);
+}
+
+void AFGGridActor::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	if (UFGGridSubsystem* GridSubsystem = UWorld::GetSubsystem<UFGGridSubsystem>(GetWorld()))
+	{
+		GridSubsystem->RegisterGrid(this);
+	}
+}
+
+void AFGGridActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFGGridSubsystem* GridSubsystem = UWorld::GetSubsystem<UFGGridSubsystem>(GetWorld()))
+	{
+		GridSubsystem->UnregisterGrid(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AFGGridActor::BeginPlay()
 {
 	Super::BeginPlay();
 
+	RebuildObstacleGrid();
+	RebuildComponentLabels();
+	RebuildClearance();
 	JPSPreProcess();
+	InfluenceMap.SetObstacles(PathGrid.ObstacleGrid);
+	Occupancy.Init(Width, Height);
+	UpdateOccupants();
+	CommittedSize = FIntPoint(Width, Height);
+
+	if (IsReplicatedServer())
+		ObstacleDeltas.RecordBase(*this);
 
 	//TArray<int32> path = JPSRuntime(36, 7);
 	//TArray<int32> path = FindPath(36, 7);
 }
 
+void AFGGridActor::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	PathFollowers.Tick(DeltaSeconds);
+	InfluenceMap.PassesPerSecond = InfluencePassesPerSecond;
+	InfluenceMap.Update(DeltaSeconds, InfluenceBudgetMs * 0.001);
+	UpdateOccupants();
+
+	// followers turn it back on when they get a path, new layers and occupants when they get added
+	if (PathFollowers.NumFollowingPath() == 0 && InfluenceMap.NumLayers() == 0 && Occupancy.NumOccupants() == 0)
+		SetActorTickEnabled(false);
+}
+
 void AFGGridActor::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
@@ -44,6 +229,8 @@ void AFGGridActor::OnConstruction(const FTransform& Transform)
 		TileList.SetNum(GetNumTiles());
 	}
 
+	FitTileCosts();
+
 	GenerateGrid();
 
 	DrawBlocks();
@@ -59,11 +246,11 @@ FVector AFGGridActor::GetWorldLocationFromXY(int32 TileX, int32 TileY) const
 
 bool AFGGridActor::GetXYFromWorldLocation(const FVector& WorldLocation, int32& TileX, int32& TileY) const
 {
-	if (!IsWorldLocationInsideGrid(WorldLocation))
-		return false;
-
 	const FVector RelativeGridLocation = GetActorTransform().InverseTransformPositionNoScale(WorldLocation);
 
+	if (FMath::Abs(RelativeGridLocation.X) > GetWidthSize() || FMath::Abs(RelativeGridLocation.Y) > GetHeightSize())
+		return false;
+
 	const float HeightOffset = (Height % 2) == 1 ? 0.5f : 0.0f;
 	const float WidthOffset = (Width % 2) == 1 ? 0.5f : 0.0f;
 
@@ -107,6 +294,143 @@ bool AFGGridActor::TransformWorldLocationToTileLocation(const FVector& InWorldLo
 
 
 
+const AFGGridActor::FTransformCache& AFGGridActor::GetTransformCache() const
+{
+	const FTransform& ActorTransform = GetActorTransform();
+	if (TransformCache.bValid
+		&& TransformCache.Width == Width && TransformCache.Height == Height
+		&& TransformCache.TileSize == TileSize && TransformCache.BorderSize == BorderSize
+		&& TransformCache.SourceTransform.Equals(ActorTransform, 0.0f))
+	{
+		return TransformCache;
+	}
+
+	const FQuat Rotation = ActorTransform.GetRotation();
+	const FVector Scale = ActorTransform.GetScale3D();
+
+	TransformCache.SourceTransform = ActorTransform;
+	TransformCache.Width = Width;
+	TransformCache.Height = Height;
+	TransformCache.TileSize = TileSize;
+	TransformCache.BorderSize = BorderSize;
+	TransformCache.Origin = ActorTransform.GetLocation();
+	TransformCache.InvAxisX = Rotation.GetAxisX();
+	TransformCache.InvAxisY = Rotation.GetAxisY();
+	TransformCache.AxisX = Rotation.GetAxisX() * Scale.X;
+	TransformCache.AxisY = Rotation.GetAxisY() * Scale.Y;
+	TransformCache.bValid = true;
+
+	return TransformCache;
+}
+
+void AFGGridActor::GetTileIndicesFromWorldLocations(TArrayView<const FVector> WorldLocations,
+                                                    TArrayView<int32> OutTileIndices) const
+{
+	check(OutTileIndices.Num() >= WorldLocations.Num());
+
+	const FTransformCache& Cache = GetTransformCache();
+	const int32 Num = WorldLocations.Num();
+
+	/*
+	* Same math as GetXYFromWorldLocation. The odd/even offsets there work out to floor(Local / TileSize + HalfWidth),
+	* and truncating after clamping to 0 gives the same tile as flooring would.
+	*/
+	const float InvTileSize = 1.0f / TileSize;
+	const float WidthSize = GetWidthSize();
+	const float HeightSize = GetHeightSize();
+
+	const VectorRegister OriginX = VectorSetFloat1(Cache.Origin.X);
+	const VectorRegister OriginY = VectorSetFloat1(Cache.Origin.Y);
+	const VectorRegister OriginZ = VectorSetFloat1(Cache.Origin.Z);
+	const VectorRegister InvXX = VectorSetFloat1(Cache.InvAxisX.X);
+	const VectorRegister InvXY = VectorSetFloat1(Cache.InvAxisX.Y);
+	const VectorRegister InvXZ = VectorSetFloat1(Cache.InvAxisX.Z);
+	const VectorRegister InvYX = VectorSetFloat1(Cache.InvAxisY.X);
+	const VectorRegister InvYY = VectorSetFloat1(Cache.InvAxisY.Y);
+	const VectorRegister InvYZ = VectorSetFloat1(Cache.InvAxisY.Z);
+	const VectorRegister HalfExtentX = VectorSetFloat1(WidthSize);
+	const VectorRegister HalfExtentY = VectorSetFloat1(HeightSize);
+	const VectorRegister InvTileSizeV = VectorSetFloat1(InvTileSize);
+	const VectorRegister HalfWidthV = VectorSetFloat1(GetHalfWidth());
+	const VectorRegister HalfHeightV = VectorSetFloat1(GetHalfHeight());
+	const VectorRegister MaxTileX = VectorSetFloat1(static_cast<float>(Width - 1));
+	const VectorRegister MaxTileY = VectorSetFloat1(static_cast<float>(Height - 1));
+	const VectorRegister Zero = VectorZero();
+
+	int32 Index = 0;
+	for (; Index + 4 <= Num; Index += 4)
+	{
+		const FVector* P = &WorldLocations[Index];
+		const VectorRegister DX = VectorSubtract(MakeVectorRegister(P[0].X, P[1].X, P[2].X, P[3].X), OriginX);
+		const VectorRegister DY = VectorSubtract(MakeVectorRegister(P[0].Y, P[1].Y, P[2].Y, P[3].Y), OriginY);
+		const VectorRegister DZ = VectorSubtract(MakeVectorRegister(P[0].Z, P[1].Z, P[2].Z, P[3].Z), OriginZ);
+
+		const VectorRegister LocalX = VectorMultiplyAdd(DZ, InvXZ, VectorMultiplyAdd(DY, InvXY, VectorMultiply(DX, InvXX)));
+		const VectorRegister LocalY = VectorMultiplyAdd(DZ, InvYZ, VectorMultiplyAdd(DY, InvYY, VectorMultiply(DX, InvYX)));
+
+		const int32 InsideMask = VectorMaskBits(VectorBitwiseAnd(
+			VectorCompareLE(VectorAbs(LocalX), HalfExtentX),
+			VectorCompareLE(VectorAbs(LocalY), HalfExtentY)));
+
+		const VectorRegister TileX = VectorTruncate(VectorMin(VectorMax(VectorMultiplyAdd(LocalX, InvTileSizeV, HalfWidthV), Zero), MaxTileX));
+		const VectorRegister TileY = VectorTruncate(VectorMin(VectorMax(VectorMultiplyAdd(LocalY, InvTileSizeV, HalfHeightV), Zero), MaxTileY));
+
+		float TileXs[4], TileYs[4];
+		VectorStore(TileX, TileXs);
+		VectorStore(TileY, TileYs);
+
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			OutTileIndices[Index + Lane] = (InsideMask & (1 << Lane))
+				                               ? static_cast<int32>(TileYs[Lane]) * Width + static_cast<int32>(TileXs[Lane])
+				                               : INDEX_NONE;
+		}
+	}
+
+	for (; Index < Num; ++Index)
+	{
+		const FVector Delta = WorldLocations[Index] - Cache.Origin;
+		const float LocalX = FVector::DotProduct(Delta, Cache.InvAxisX);
+		const float LocalY = FVector::DotProduct(Delta, Cache.InvAxisY);
+
+		if (FMath::Abs(LocalX) > WidthSize || FMath::Abs(LocalY) > HeightSize)
+		{
+			OutTileIndices[Index] = INDEX_NONE;
+			continue;
+		}
+
+		const int32 TileX = FMath::Clamp(FMath::FloorToInt(LocalX * InvTileSize + GetHalfWidth()), 0, Width - 1);
+		const int32 TileY = FMath::Clamp(FMath::FloorToInt(LocalY * InvTileSize + GetHalfHeight()), 0, Height - 1);
+		OutTileIndices[Index] = TileY * Width + TileX;
+	}
+}
+
+void AFGGridActor::GetWorldLocationsFromTileIndices(TArrayView<const int32> TileIndices,
+                                                    TArrayView<FVector> OutWorldLocations) const
+{
+	check(OutWorldLocations.Num() >= TileIndices.Num());
+
+	const FTransformCache& Cache = GetTransformCache();
+	const float OffsetX = GetTileSizeHalf() - GetHalfWidth() * TileSize;
+	const float OffsetY = GetTileSizeHalf() - GetHalfHeight() * TileSize;
+	const int32 NumTiles = GetNumTiles();
+
+	// Plain loop over precomputed axes, nothing in here the compiler can't vectorize on its own
+	for (int32 Index = 0, Num = TileIndices.Num(); Index < Num; ++Index)
+	{
+		const int32 TileIndex = TileIndices[Index];
+		if (TileIndex < 0 || TileIndex >= NumTiles)
+		{
+			OutWorldLocations[Index] = FVector::ZeroVector;
+			continue;
+		}
+
+		const float LocalX = static_cast<float>(TileIndex % Width) * TileSize + OffsetX;
+		const float LocalY = static_cast<float>(TileIndex / Width) * TileSize + OffsetY;
+		OutWorldLocations[Index] = Cache.Origin + Cache.AxisX * LocalX + Cache.AxisY * LocalY;
+	}
+}
+
 void AFGGridActor::GetOverlappingTiles(const FVector& Origin, const FVector& Extent,
                                        TArray<int32>& OutOverlappingTiles) const
 {
@@ -185,12 +509,40 @@ void AFGGridActor::DrawBlocks()
 
 void AFGGridActor::UpdateBlockingTiles()
 {
-	TArray<UFGGridBlockComponent*> AllBlocks;
-	GetComponents(AllBlocks);
+	// the server owns the obstacles, clients only get them through ObstacleDeltas
+	if (IsReplicatedClient())
+		return;
+
+	const TBitArray<> PreviousBlocks = GetBlockedTiles();
 
 	TileList.Empty();
 	TileList.SetNum(GetNumTiles());
 
+	ComponentBlocks = GetComponentBlockedTiles();
+	for (TConstSetBitIterator<> It(ComponentBlocks); It; ++It)
+	{
+		TileList[It.GetIndex()].bBlock = true;
+	}
+
+	for (int32 Word = 0; Word < ImportedBlocks.Num() && ImportedSize == FIntPoint(Width, Height); ++Word)
+	{
+		for (uint32 Bits = ImportedBlocks[Word]; Bits != 0; Bits &= Bits - 1)
+		{
+			const int32 TileIndex = Word * 32 + FMath::CountTrailingZeros(Bits);
+			if (TileIndex < TileList.Num())
+				TileList[TileIndex].bBlock = true;
+		}
+	}
+
+	CommitTileChanges(PreviousBlocks);
+}
+
+TBitArray<> AFGGridActor::GetComponentBlockedTiles() const
+{
+	TArray<UFGGridBlockComponent*> AllBlocks;
+	GetComponents(AllBlocks);
+
+	TBitArray<> BlockedTiles(false, GetNumTiles());
 	TArray<int32> BlockIndices;
 
 	for (const auto Block : AllBlocks)
@@ -203,11 +555,246 @@ void AFGGridActor::UpdateBlockingTiles()
 
 		for (int32 Index = 0, Num = BlockIndices.Num(); Index < Num; ++Index)
 		{
-			TileList[BlockIndices[Index]].bBlock = true;
+			BlockedTiles[BlockIndices[Index]] = true;
+		}
+	}
+	return BlockedTiles;
+}
+
+void AFGGridActor::PaintImportedTiles(TArrayView<const int32> Tiles, bool bBlock, TArray<int32>& OutChangedTiles)
+{
+	if (IsReplicatedClient() || TileList.Num() != GetNumTiles())
+		return;
+
+	if (ImportedSize != FIntPoint(Width, Height))
+	{
+		ImportedSize = FIntPoint(Width, Height);
+		ImportedBlocks.Init(0, FMath::DivideAndRoundUp(GetNumTiles(), 32));
+	}
+
+	// erasing must not clear what a block component still covers
+	if (ComponentBlocks.Num() != GetNumTiles())
+		ComponentBlocks = GetComponentBlockedTiles();
+
+	const bool bPathGridMatches = PathGrid.Width == Width && PathGrid.Height == Height;
+
+	TArray<int32> ChangedTiles;
+	for (const int32 Tile : Tiles)
+	{
+		if (!IsTileIndexValid(Tile))
+			continue;
+
+		const uint32 Mask = 1u << (Tile & 31);
+		if (bBlock)
+			ImportedBlocks[Tile >> 5] |= Mask;
+		else
+			ImportedBlocks[Tile >> 5] &= ~Mask;
+
+		const bool bNewBlock = bBlock || ComponentBlocks[Tile];
+		if (TileList[Tile].bBlock == bNewBlock)
+			continue;
+
+		TileList[Tile].bBlock = bNewBlock;
+		ChangedTiles.Add(Tile);
+		if (bPathGridMatches)
+		{
+			const int32 X = Tile % Width;
+			const int32 Y = Tile / Width;
+			PathGrid.ObstacleGrid.SetBlocked(X, Y, bNewBlock);
+			PathGrid.CostGrid.SetCost(X, Y, GetTileCost(Tile), PathGrid.ObstacleGrid);
 		}
 	}
 
+	if (ChangedTiles.Num() == 0)
+		return;
+
+	ChangedTiles.Sort();
+	OutChangedTiles.Append(ChangedTiles);
+	bTileEditsPending = true;
+
+	if (!bPathGridMatches)
+		return;
+
+	// the jump distances run through the edited tiles until FinishTileEdits, better no jump data than wrong jump data
+	if (PathGrid.HasJumpData())
+	{
+		PathGrid.ClearJumpData();
+		bRebuildJumpsAfterEdits = true;
+	}
+
+	PathGrid.ApplyTileChanges(ChangedTiles);
+	InfluenceMap.ApplyTileChanges(PathGrid.ObstacleGrid, ChangedTiles);
+	MarkPathGridDirty();
+	if (IsReplicatedServer())
+		ObstacleDeltas.RecordChanges(*this, ChangedTiles);
+	OnTilesChanged.Broadcast(ChangedTiles);
+}
+
+void AFGGridActor::FinishTileEdits()
+{
+	if (!bTileEditsPending)
+		return;
+
+	bTileEditsPending = false;
+	DrawBlocks();
+
+	if (bRebuildJumpsAfterEdits)
+	{
+		bRebuildJumpsAfterEdits = false;
+		JPSPreProcess();
+	}
+}
+
+TBitArray<> AFGGridActor::GetBlockedTiles() const
+{
+	TBitArray<> BlockedTiles(false, TileList.Num());
+	for (int32 Index = 0, Num = TileList.Num(); Index < Num; ++Index)
+	{
+		BlockedTiles[Index] = TileList[Index].bBlock;
+	}
+	return BlockedTiles;
+}
+
+void AFGGridActor::CommitTileChanges(const TBitArray<>& PreviousBlocks)
+{
+	// a resize can keep the tile count (10x20 to 20x10), only the dimensions say whether the derived data still fits
+	const bool bSameSize = CommittedSize == FIntPoint(Width, Height) && PreviousBlocks.Num() == GetNumTiles();
+	CommittedSize = FIntPoint(Width, Height);
+
+	// costs aren't tied to components, they only start over when the grid changes size
+	FitTileCosts();
+
 	DrawBlocks();
+	RebuildObstacleGrid();
+
+	// stale jump distances would run straight through the new blocks
+	if (PathGrid.HasJumpData())
+		JPSPreProcess();
+
+	if (!bSameSize)
+	{
+		RebuildComponentLabels();
+		RebuildClearance();
+		InfluenceMap.SetObstacles(PathGrid.ObstacleGrid);
+		Occupancy.Init(Width, Height);
+		UpdateOccupants();
+		if (IsReplicatedServer())
+			ObstacleDeltas.RecordBase(*this);
+		return;
+	}
+
+	TArray<int32> ChangedTiles;
+	for (int32 Index = 0, Num = TileList.Num(); Index < Num; ++Index)
+	{
+		if (PreviousBlocks[Index] != TileList[Index].bBlock)
+			ChangedTiles.Add(Index);
+	}
+
+	if (ChangedTiles.Num() > 0)
+	{
+		PathGrid.ApplyTileChanges(ChangedTiles);
+		InfluenceMap.ApplyTileChanges(PathGrid.ObstacleGrid, ChangedTiles);
+		MarkPathGridDirty();
+		if (IsReplicatedServer())
+			ObstacleDeltas.RecordChanges(*this, ChangedTiles);
+		OnTilesChanged.Broadcast(ChangedTiles);
+	}
+}
+
+bool AFGGridActor::IsReplicatedServer() const
+{
+	const UWorld* World = GetWorld();
+	return World != nullptr && World->IsGameWorld() && HasAuthority();
+}
+
+bool AFGGridActor::IsReplicatedClient() const
+{
+	const UWorld* World = GetWorld();
+	return World != nullptr && World->IsGameWorld() && !HasAuthority();
+}
+
+void AFGGridActor::ApplyReplicatedObstacles()
+{
+	if (!IsReplicatedClient())
+		return;
+
+	const uint32 AppliedVersion = ObstacleDeltas.LatestVersion;
+	const TBitArray<> PreviousBlocks = GetBlockedTiles();
+
+	auto SetRuns = [this](const FFGTileRuns& Runs, bool bBlock)
+	{
+		const int32 NumTiles = TileList.Num();
+		for (int32 Run = 0; Run < Runs.Num(); ++Run)
+		{
+			const int32 RunEnd = FMath::Min(Runs.Starts[Run] + Runs.Lengths[Run], NumTiles);
+			for (int32 Tile = FMath::Max(Runs.Starts[Run], 0); Tile < RunEnd; ++Tile)
+			{
+				TileList[Tile].bBlock = bBlock;
+			}
+		}
+	};
+
+	// a newer base replaces whatever we had, the deltas after it then have to follow without gaps
+	const FFGObstacleDelta* NewestBase = nullptr;
+	for (const FFGObstacleDelta& Item : ObstacleDeltas.Items)
+	{
+		if (Item.bBase && Item.Version > ObstacleDeltas.LatestVersion && (NewestBase == nullptr || Item.Version > NewestBase->Version))
+			NewestBase = &Item;
+	}
+
+	// NetSerialize already kept the runs below MAX_int32, what's left is a base that doesn't fit its own grid
+	if (NewestBase != nullptr && (NewestBase->Width < 1 || NewestBase->Height < 1
+		|| static_cast<int64>(NewestBase->Width) * NewestBase->Height > MAX_int32
+		|| NewestBase->Blocked.GetEnd() > NewestBase->Width * NewestBase->Height))
+	{
+		UE_LOG(LogFGObstacleReplication, Warning, TEXT("%s: dropped obstacle base %u, it doesn't fit a %dx%d grid"),
+		       *GetName(), NewestBase->Version, NewestBase->Width, NewestBase->Height);
+		NewestBase = nullptr;
+	}
+
+	if (NewestBase != nullptr)
+	{
+		if (NewestBase->Width != Width || NewestBase->Height != Height)
+		{
+			Width = NewestBase->Width;
+			Height = NewestBase->Height;
+			GenerateGrid();
+		}
+		TileList.Reset();
+		TileList.SetNum(GetNumTiles());
+		SetRuns(NewestBase->Blocked, true);
+		ObstacleDeltas.LatestVersion = NewestBase->Version;
+	}
+
+	for (bool bFoundNext = true; bFoundNext;)
+	{
+		bFoundNext = false;
+		for (const FFGObstacleDelta& Item : ObstacleDeltas.Items)
+		{
+			if (!Item.bBase && Item.Version == ObstacleDeltas.LatestVersion + 1)
+			{
+				// a delta reaching past the grid can't be applied, and nothing after it can be either
+				if (Item.Blocked.GetEnd() > TileList.Num() || Item.Cleared.GetEnd() > TileList.Num())
+				{
+					UE_LOG(LogFGObstacleReplication, Warning, TEXT("%s: dropped obstacle delta %u, it reaches past the grid"),
+					       *GetName(), Item.Version);
+					break;
+				}
+
+				SetRuns(Item.Blocked, true);
+				SetRuns(Item.Cleared, false);
+				ObstacleDeltas.LatestVersion = Item.Version;
+				bFoundNext = true;
+			}
+		}
+	}
+
+	if (ObstacleDeltas.LatestVersion == AppliedVersion)
+		return;
+
+	UE_LOG(LogFGObstacleReplication, Verbose, TEXT("%s: obstacles at version %u (was %u)"), *GetName(), ObstacleDeltas.LatestVersion, AppliedVersion);
+
+	CommitTileChanges(PreviousBlocks);
 }
 
 void AFGGridActor::GenerateGrid()
@@ -318,6 +905,26 @@ void AFGGridActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyChanged
 
 	UpdateBlockingTiles();
 }
+
+void AFGGridActor::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	// TileList is back to how it was, PathGrid still has what undo just took back
+	ComponentBlocks.Empty();
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+	{
+		CommitTileChanges(TBitArray<>());
+		return;
+	}
+
+	TBitArray<> PreviousBlocks(false, GetNumTiles());
+	for (int32 Index = 0, Num = GetNumTiles(); Index < Num; ++Index)
+	{
+		PreviousBlocks[Index] = PathGrid.ObstacleGrid.IsBlocked(Index);
+	}
+	CommitTileChanges(PreviousBlocks);
+}
 #endif // WITH_EDITOR
 
 //struct TileEntry
@@ -331,276 +938,109 @@ void AFGGridActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyChanged
 
 TArray<int32> AFGGridActor::FindPath(const int32& start, const int32& goal)
 {
-	int32 GoalX, GoalY;
-	GetXYFromTileIndex(GoalX, GoalY, goal);
-	auto Heuristic = [GoalX, GoalY, this](int32 X, int32 Y)-> int32
-	{
-		const int32 XDiff = FMath::Abs(X - GoalX);
-		const int32 YDiff = FMath::Abs(Y - GoalY);
-		return XDiff + YDiff;
-	};
+	int32 PathLength = 0;
+	FindPathInto(start, goal, TArrayView<int32>(), PathLength);
+	return CopyScratchPath(goal, PathLength);
+}
 
-	PriorityQueue<int32> OpenQueue;
-	int32 StartX, StartY;
-	GetXYFromTileIndex(StartX, StartY, start);
-	OpenQueue.PrioritisedAdd(start, Heuristic(StartX, StartY));
+EFGPathStatus AFGGridActor::FindPathInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength)
+{
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		RebuildObstacleGrid();
 
-	struct FTileData
-	{
-		TArray<int32> GScores = TArray<int32>();
-		TArray<int32> FScores = TArray<int32>();
-		TArray<int32> Parent = TArray<int32>();
-	} TileData;
+	return FindPathInto(Start, Goal, OutPath, OutPathLength, SearchScratch);
+}
 
-	const int32 NumTiles = GetNumTiles();
-	TileData.GScores.Init(0, NumTiles);
-	TileData.FScores.Init(0, NumTiles);
-	TileData.Parent.Init(-1, NumTiles);
+EFGPathStatus AFGGridActor::FindPathInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+                                         FSearchScratch& Scratch) const
+{
+	OutPathLength = 0;
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal))
+		return EFGPathStatus::InvalidTiles;
 
-	while (OpenQueue.List.Num() > 0)
-	{
-		int32 CurrentTileIdx = OpenQueue.PopFirst();
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		return EFGPathStatus::MissingData;
 
-		if (CurrentTileIdx == goal)
-		{			
-			auto path = ConstructPath(TileData.Parent, CurrentTileIdx);
-			VisualizePath(path, TileData.GScores);			
-			return path;
-		}
+	return PathGrid.FindPath(Start, Goal, OutPath, OutPathLength, Scratch);
+}
 
-		int32 TileX, TileY;
-		GetXYFromTileIndex(TileX, TileY, CurrentTileIdx);
 
-		int32 NeighborsXOffset[4] = {0, 0, -1, 1};
-		int32 NeighborsYOffset[4] = {-1, 1, 0, 0};
-		for (int i = 0; i < 4; ++i) //loop over neighbors
-		{
-			const int32 NeighborX = TileX + NeighborsXOffset[i];
-			const int32 NeighborY = TileY + NeighborsYOffset[i];
+TArray<int32> AFGGridActor::FindPathForSize(int32 Start, int32 Goal, int32 AgentSize)
+{
+	int32 PathLength = 0;
+	FindPathForSizeInto(Start, Goal, AgentSize, TArrayView<int32>(), PathLength);
+	return CopyScratchPath(Goal, PathLength);
+}
 
-			int32 NeighborIdx;
-			if (!GetTileIndexFromXY(NeighborX, NeighborY, NeighborIdx)
-				|| TileList[NeighborIdx].bBlock
-				|| NeighborIdx	== start)
-				continue; //impassable tile
+TArray<int32> AFGGridActor::JPSRuntimeForSize(int32 Start, int32 Goal, int32 AgentSize)
+{
+	int32 PathLength = 0;
+	JPSRuntimeForSizeInto(Start, Goal, AgentSize, TArrayView<int32>(), PathLength);
+	return CopyScratchPath(Goal, PathLength);
+}
 
-			const int32 NewGScore = TileData.GScores[CurrentTileIdx] + 1;
-			if (NewGScore < TileData.GScores[NeighborIdx] || TileData.GScores[NeighborIdx] == 0)
-			{
-				TileData.Parent[NeighborIdx] = CurrentTileIdx;
-				TileData.GScores[NeighborIdx] = NewGScore;
-				TileData.FScores[NeighborIdx] = NewGScore + Heuristic(NeighborX, NeighborY);
+EFGPathStatus AFGGridActor::FindPathForSizeInto(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+                                                int32& OutPathLength)
+{
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		RebuildObstacleGrid();
+	if (!PathGrid.Clearance.IsBuiltFor(Width, Height))
+		RebuildClearance();
 
-				if (OpenQueue.Contains(NeighborIdx))
-					OpenQueue.UpdatePriority(NeighborIdx, TileData.FScores[NeighborIdx]);
-				else
-					OpenQueue.PrioritisedAdd(NeighborIdx, TileData.FScores[NeighborIdx]);
-			}
-		}
-	}
-	return TArray<int32>();
+	return FindPathForSizeInto(Start, Goal, AgentSize, OutPath, OutPathLength, SearchScratch);
 }
 
+EFGPathStatus AFGGridActor::FindPathForSizeInto(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+                                                int32& OutPathLength, FSearchScratch& Scratch) const
+{
+	OutPathLength = 0;
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		return EFGPathStatus::MissingData;
 
+	return PathGrid.FindPathForSize(Start, Goal, AgentSize, OutPath, OutPathLength, Scratch);
+}
 
-bool AFGGridActor::IsObstacle(int32 X, int32 Y)
+EFGPathStatus AFGGridActor::JPSRuntimeForSizeInto(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+                                                  int32& OutPathLength)
 {
-	int32 Idx;
-	if (!GetTileIndexFromXY(X, Y, Idx) || TileList[Idx].bBlock)
-	{
-		return true; 
-	}
-	return false;
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		RebuildObstacleGrid();
+	if (!PathGrid.Clearance.IsBuiltFor(Width, Height))
+		RebuildClearance();
+	// a size of 1 goes to the regular JPSRuntime and its jump data
+	if (AgentSize <= 1 && !PathGrid.HasJumpData())
+		JPSPreProcess();
+
+	return JPSRuntimeForSizeInto(Start, Goal, AgentSize, OutPath, OutPathLength, SearchScratch);
 }
 
-void AFGGridActor::JPSPreProcess()
+EFGPathStatus AFGGridActor::JPSRuntimeForSizeInto(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+                                                  int32& OutPathLength, FSearchScratch& Scratch) const
 {
-	const auto NumTiles = GetNumTiles();
-	
-#pragma region primary_jump_points
-	for (int TileIndex = 0; TileIndex < NumTiles; ++TileIndex)
-	{		
-		struct BlockCase
-		{
-			IVec2 Offset;
-			struct
-			{
-				IVec2 N;
-				eDir Dir;
-			} FNCase1;
-			struct
-			{
-				IVec2 N;
-				eDir Dir;
-			} FNCase2;
-		};
+	OutPathLength = 0;
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		return EFGPathStatus::MissingData;
 
-		BlockCase Cases[4] = {
-			{Directions[Northwest],{Directions[North], East},{Directions[West],South}},
-			{Directions[Northeast],{Directions[North], West},{Directions[East], South}},
-			{Directions[Southwest],{Directions[West], North},{Directions[South], East}},
-			{Directions[Southeast],{Directions[East], North},{Directions[South], West}}
-		};
-
-		int32 CX, CY;
-		GetXYFromTileIndex(CX,CY,TileIndex);
-
-		for (int j = 0; j < 4; ++j)
-		{
-			int32 Idx;
-			bool got = GetTileIndexFromXY(CX+Cases[j].Offset.x, CY+Cases[j].Offset.y, Idx);
-			if (!got
-				|| !TileList[Idx].bBlock)
-				continue;
-
-			int32 FNIdx;
-			if (GetTileIndexFromXY(CX+Cases[j].FNCase1.N.x, CY+Cases[j].FNCase1.N.y, FNIdx) && !TileList[FNIdx].bBlock)
-			{
-				const IVec2 ApproachDir = Directions[Cases[j].FNCase1.Dir];
-				if (!IsObstacle(CX-ApproachDir.x, CY-ApproachDir.y)) 
-					TileList[TileIndex].ApproachDirs[Cases[j].FNCase1.Dir] = true; 					
-			}
-			if (GetTileIndexFromXY(CX+Cases[j].FNCase2.N.x, CY+Cases[j].FNCase2.N.y, FNIdx) && !TileList[FNIdx].bBlock)
-			{
-				const IVec2 ApproachDir = Directions[Cases[j].FNCase2.Dir];
-				if (!IsObstacle(CX-ApproachDir.x, CY-ApproachDir.y))
-					TileList[TileIndex].ApproachDirs[Cases[j].FNCase2.Dir] = true; 
-			}
-		}		
-	}
-#pragma endregion
+	return PathGrid.JPSRuntimeForSize(Start, Goal, AgentSize, OutPath, OutPathLength, Scratch);
+}
 
-#pragma region CardinalSweeps
+int32 AFGGridActor::GetTileClearance(int32 TileIndex) const
+{
+	if (!IsTileIndexValid(TileIndex) || !PathGrid.Clearance.IsBuiltFor(Width, Height))
+		return 0;
 
-	auto CardinalSweep = [this](const int32 X,const int32 Y,
-                        eDir Dir,  int32& Distance, bool& jumpPointLastSeen)
-	{
-		int32 Idx;
-		GetTileIndexFromXY(X, Y, Idx);
-		
-		if(TileList[Idx].bBlock)
-		{				
-			Distance = -1;
-			jumpPointLastSeen = false;
-			TileList[Idx].DirectionValues[Dir] = 0;
-			return;
-		}
-			
-		Distance = Distance + 1;
+	return PathGrid.Clearance.Clearance[TileIndex];
+}
 
-		if (jumpPointLastSeen)
-			TileList[Idx].DirectionValues[Dir] = Distance;
-		else
-			TileList[Idx].DirectionValues[Dir] = -Distance;
-			
-		if (TileList[Idx].ApproachDirs[Dir]) //this is a jump point for westward direction
-		{
-			Distance = 0;
-			jumpPointLastSeen = true;
-		}	
-	};
-	
-	//SweepRight_WestwardValues
-	for (int Y = 0; Y < Height; ++Y)
-	{
-		int32 Distance = -1;
-		bool bJumpPointLastSeen = false;
-		for (int X = 0; X < Width; ++X)
-			CardinalSweep(X, Y, eDir::West, Distance, bJumpPointLastSeen);
-	}
-	
-	//SweepLeft_EastwardValues	
-	for (int Y = 0; Y < Height; ++Y)
-	{
-		int32 Distance = -1;
-		bool bJumpPointLastSeen = false;
-		for (int X = Width - 1; X >= 0; --X)		
-			CardinalSweep(X, Y, eDir::East, Distance, bJumpPointLastSeen);
-	}
-	
-	//SweepDown_NorthwardValues
-	for (int X = 0; X < Width; ++X)
-	{
-		int32 Distance = -1;
-		bool bJumpPointLastSeen = false;
-		for (int Y = 0; Y < Height; ++Y)
-			CardinalSweep(X, Y, eDir::North, Distance, bJumpPointLastSeen);
-	}
-	
-	//SweepUp_SouthwardValues
-	for (int X = 0; X < Width; ++X)
-	{
-		int32 Distance = -1;
-		bool bJumpPointLastSeen = false;
-		for (int Y = Height - 1; Y >= 0; --Y)
-			CardinalSweep(X, Y, eDir::South, Distance, bJumpPointLastSeen);
-	}	
-#pragma endregion
-
-#pragma region Diagonals
-	auto DiagonalSweep = [this](const int32 X, const int32 Y,
-                    eDir Vertical, eDir Horizontal, eDir Diagonal, FFGTileinfo& CurrentTileInfo)
-	{
-		const IVec2 DiagonalOffset = Directions[Diagonal];
-		
-		int32 PrevIdx;				
-		GetTileIndexFromXY(X+DiagonalOffset.x, Y+DiagonalOffset.y, PrevIdx);		
-			
-		if (IsObstacle(X, Y+DiagonalOffset.y)
-            || IsObstacle(X+DiagonalOffset.x,Y) || IsObstacle(X+DiagonalOffset.x,Y+DiagonalOffset.y))
-		{
-			CurrentTileInfo.DirectionValues[Diagonal] = 0;
-		}
-		else if (!IsObstacle(X,Y+DiagonalOffset.y) && !IsObstacle(X+DiagonalOffset.x, Y)
-            && (TileList[PrevIdx].DirectionValues[Vertical] > 0
-                ||  TileList[PrevIdx].DirectionValues[Horizontal] > 0))
-		{
-			CurrentTileInfo.DirectionValues[Diagonal] = 1;
-		}
-		else
-		{
-			int JumpDistance = TileList[PrevIdx].DirectionValues[Diagonal];
-			if (JumpDistance > 0)
-			{
-				CurrentTileInfo.DirectionValues[Diagonal] = 1 + JumpDistance;
-			}
-			else
-			{
-				CurrentTileInfo.DirectionValues[Diagonal] = -1 + JumpDistance;
-			}
-		}
-	};
-	
-	
-	for (int Y = Height - 1; Y >= 0; --Y)
-	{
-		for (int X = 0; X < Width; ++X)
-		{
-			int32 Idx;			
-			GetTileIndexFromXY(X, Y, Idx);
-			if(!IsObstacle(X,Y))
-			{				
-				DiagonalSweep(X, Y, eDir::South, eDir::West, eDir::Southwest, TileList[Idx]);
-				DiagonalSweep(X, Y, eDir::South, eDir::East, eDir::Southeast, TileList[Idx]);
-			}
-		}
-	}
-	
-	for (int Y = 0; Y < Height; ++Y)
-	{
-		for (int X = 0; X < Width; ++X)
-		{
-			int32 Idx;			
-			GetTileIndexFromXY(X, Y, Idx);
-			if(!IsObstacle(X,Y))
-			{
-				DiagonalSweep(X, Y, eDir::North, eDir::West, eDir::Northwest, TileList[Idx]);
-				DiagonalSweep(X, Y, eDir::North, eDir::East, eDir::Northeast, TileList[Idx]);
-			}
-		}
-	}		
-#pragma endregion
+void AFGGridActor::JPSPreProcess()
+{
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		RebuildObstacleGrid();
 
+	PathGrid.JPSPreProcess();
+	if (bGoalBounding)
+		PathGrid.BuildGoalBounds();
+	MarkPathGridDirty();
 }
 
 void AFGGridActor::VisualizePath(const TArray<int32>& path, const TArray<int32>& GScores)
@@ -608,7 +1048,7 @@ void AFGGridActor::VisualizePath(const TArray<int32>& path, const TArray<int32>&
 	for (int i = 0; i < GScores.Num(); ++i)
 	{
 		int32 X, Y;
-		if (GScores[i] == 0)
+		if (GScores[i] == 0 || GScores[i] == MAX_int32)
 		{
 			continue;
 		}
@@ -636,193 +1076,1273 @@ void AFGGridActor::VisualizePath(const TArray<int32>& path, const TArray<int32>&
 
 TArray<int32> AFGGridActor::ConstructPath(const TArray<int32>& Parent, const int32& Goal)
 {
+	int32 PathLength = 0;
+	ConstructPathInto(Parent, Goal, TArrayView<int32>(), PathLength);
+
+	TArray<int32> path;
+	path.SetNumUninitialized(PathLength);
+	ConstructPathInto(Parent, Goal, path, PathLength);
+	return path;
+}
+
+EFGPathStatus AFGGridActor::ConstructPathInto(const TArray<int32>& Parent, int32 Goal, TArrayView<int32> OutPath,
+                                              int32& OutPathLength) const
+{
+	return PathGrid.ConstructPath(Parent, Goal, OutPath, OutPathLength);
+}
+
+TArray<int32> AFGGridActor::CopyScratchPath(int32 Goal, int32 PathLength)
+{
+	if (PathLength == 0)
+		return TArray<int32>();
+
 	TArray<int32> path;
+	path.SetNumUninitialized(PathLength);
+	ConstructPathInto(SearchScratch.Parent, Goal, path, PathLength);
+#if ENABLE_DRAW_DEBUG
+	if (bDrawDebugPaths)
+		VisualizePath(path, SearchScratch.GScores);
+#endif
+	return path;
+}
+
+void AFGGridActor::RebuildObstacleGrid()
+{
+	FitTileCosts();
+	PathGrid.SetObstacles(Width, Height, [this](int32 TileIndex)
+	{
+		return TileList.IsValidIndex(TileIndex) && TileList[TileIndex].bBlock;
+	}, TileCosts);
+	MarkPathGridDirty();
+}
+
+void AFGGridActor::RebuildComponentLabels()
+{
+	PathGrid.RebuildComponentLabels();
+	MarkPathGridDirty();
+}
+
+void AFGGridActor::RebuildClearance()
+{
+	PathGrid.RebuildClearance();
+	MarkPathGridDirty();
+}
+
+FFGPathGridSnapshot AFGGridActor::AcquirePathGridSnapshot()
+{
+	// only the game thread publishes, and only it may look at the flag
+	if (IsInGameThread() && bPathGridDirty)
+		PublishPathGrid();
+
+	FScopeLock Lock(&SnapshotLock);
+	return PublishedPathGrid;
+}
+
+void AFGGridActor::PublishPathGrid()
+{
+	// nobody can pick up the retired version anymore, so once it's unique it is ours to overwrite
+	TSharedPtr<FFGPathGrid, ESPMode::ThreadSafe> NextGrid = MoveTemp(RetiredPathGrid);
+	if (!NextGrid.IsValid() || !NextGrid.IsUnique())
+		NextGrid = MakeShared<FFGPathGrid, ESPMode::ThreadSafe>();
+
+	++PathGrid.Version;
+
+	/*
+	* Everything but the jump data is a few bytes per tile, copying it is no more than the edit that dirtied it cost.
+	* The jump tiles (about 100 bytes each with the goal bounds) only change with a JPSPreProcess, so the retired copy
+	* keeps its own when they are still current. A rebuild therefore costs at most two copies, one per buffer.
+	*/
+	if (NextGrid->JumpRevision == PathGrid.JumpRevision)
+	{
+		TArray<FFGJumpTile> CurrentJumps = MoveTemp(NextGrid->JumpTiles);
+		TArray<FFGJumpTile> LiveJumps = MoveTemp(PathGrid.JumpTiles);
+		*NextGrid = PathGrid;
+		PathGrid.JumpTiles = MoveTemp(LiveJumps);
+		NextGrid->JumpTiles = MoveTemp(CurrentJumps);
+	}
+	else
+	{
+		*NextGrid = PathGrid;
+	}
+	bPathGridDirty = false;
+
+	FScopeLock Lock(&SnapshotLock);
+	RetiredPathGrid = MoveTemp(PublishedPathGrid);
+	PublishedPathGrid = MoveTemp(NextGrid);
+}
+
+bool AFGGridActor::AreTilesConnected(int32 TileA, int32 TileB, EFGConnectivity Connectivity) const
+{
+	const FFGComponentLabels& Labels = Connectivity == EFGConnectivity::Eight ? PathGrid.ComponentLabels8 : PathGrid.ComponentLabels4;
+	return Labels.AreConnected(TileA, TileB);
+}
+
+bool AFGGridActor::IsGoalUnreachable(int32 Start, int32 Goal) const
+{
+	return PathGrid.IsGoalUnreachable(Start, Goal);
+}
+
+bool AFGGridActor::HasLineOfSight(int32 FromTile, int32 ToTile) const
+{
+	int32 FromX, FromY, ToX, ToY;
+	if (!GetXYFromTileIndex(FromX, FromY, FromTile) || !GetXYFromTileIndex(ToX, ToY, ToTile))
+		return false;
+
+	return PathGrid.ObstacleGrid.HasLineOfSight(FromX, FromY, ToX, ToY);
+}
+
+void AFGGridActor::HasLineOfSightBatch(TArrayView<const FFGTilePair> Pairs, TArrayView<bool> OutResults) const
+{
+	FFGVisibility::HasLineOfSightBatch(PathGrid.ObstacleGrid, Pairs, OutResults);
+}
+
+TArray<int32> AFGGridActor::GetVisibleTiles(int32 Origin, int32 Radius) const
+{
+	TArray<int32> VisibleTiles;
+	FFGVisibility::ComputeFieldOfView(PathGrid.ObstacleGrid, Origin, Radius, VisibleTiles);
+	return VisibleTiles;
+}
+
+TArray<int32> AFGGridActor::SmoothPath(const TArray<int32>& Path) const
+{
+	if (Path.Num() <= 2)
+		return Path;
 
-	int32 CurrentIdx = Goal;
-	while (CurrentIdx != -1)
+	TArray<int32> Result;
+	Result.Add(Path[0]);
+
+	int32 Anchor = 0;
+	for (int32 i = 2; i < Path.Num(); ++i)
 	{
-		path.Add(CurrentIdx);
-		CurrentIdx = Parent[CurrentIdx];
+		if (!HasLineOfSight(Path[Anchor], Path[i]))
+		{
+			Anchor = i - 1;
+			Result.Add(Path[Anchor]);
+		}
 	}
+
+	Result.Add(Path.Last());
+	return Result;
+}
+
+void AFGGridActor::FFrontier::Prepare(int32 NumTiles)
+{
+	G.Init(MAX_int32, NumTiles);
+	Parent.Init(-1, NumTiles);
+	Closed.Init(false, NumTiles);
+	OpenQueue.Reset();
+	OpenQueue.Reserve(NumTiles);
+	Touched.Reset();
+}
+
+TArray<int32> AFGGridActor::BidirectionalAStar(int32 Start, int32 Goal, bool bAllowDiagonal, bool bParallel)
+{
+	int32 PathLength = 0;
+	if (BidirectionalAStarInto(Start, Goal, bAllowDiagonal, bParallel, TArrayView<int32>(), PathLength) != EFGPathStatus::Truncated)
+		return TArray<int32>();
+
+	// the frontiers still hold the search, no need to run it again for a buffer that fits
+	TArray<int32> path;
+	path.SetNumUninitialized(PathLength);
+	WriteBidirectionalPath(path);
 	return path;
 }
 
-TArray<int32> AFGGridActor::JPSRuntime(int32 Start, int32 Goal)
-{	
-	struct SearchDirs
+int32 AFGGridActor::WriteBidirectionalPath(TArrayView<int32> OutPath) const
+{
+	if (BidirectionalMeetTile == -1)
+		return 0;
+
+	// start..meet from the forward parents, then meet..goal from the backward ones
+	int32 PathLength = 0;
+	for (int32 TileIdx = BidirectionalMeetTile; TileIdx != -1; TileIdx = ForwardFrontier.Parent[TileIdx])
+		++PathLength;
+	const int32 ForwardLength = PathLength;
+	for (int32 TileIdx = BackwardFrontier.Parent[BidirectionalMeetTile]; TileIdx != -1; TileIdx = BackwardFrontier.Parent[TileIdx])
+		++PathLength;
+
+	int32 WriteIdx = ForwardLength - 1;
+	for (int32 TileIdx = BidirectionalMeetTile; TileIdx != -1; TileIdx = ForwardFrontier.Parent[TileIdx], --WriteIdx)
+	{
+		if (WriteIdx < OutPath.Num())
+			OutPath[WriteIdx] = TileIdx;
+	}
+	WriteIdx = ForwardLength;
+	for (int32 TileIdx = BackwardFrontier.Parent[BidirectionalMeetTile]; TileIdx != -1 && WriteIdx < OutPath.Num();
+	     TileIdx = BackwardFrontier.Parent[TileIdx], ++WriteIdx)
+	{
+		OutPath[WriteIdx] = TileIdx;
+	}
+	return PathLength;
+}
+
+EFGPathStatus AFGGridActor::BidirectionalAStarInto(int32 Start, int32 Goal, bool bAllowDiagonal, bool bParallel,
+                                                   TArrayView<int32> OutPath, int32& OutPathLength)
+{
+	OutPathLength = 0;
+	BidirectionalMeetTile = -1;
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal))
+		return EFGPathStatus::InvalidTiles;
+
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		RebuildObstacleGrid();
+
+	if (IsGoalUnreachable(Start, Goal) || TileList[Goal].bBlock)
+		return EFGPathStatus::NoPath;
+
+	constexpr int32 CardinalCost = 10;
+	constexpr int32 DiagonalCost = 14;
+	const int32 NumDirections = bAllowDiagonal ? 8 : 4;
+
+	auto Heuristic = [this, bAllowDiagonal](int32 From, int32 To)-> int32
 	{
-		eDir TravelDir;
-		TArray<eDir> ValidDirs;
+		int32 FromX, FromY, ToX, ToY;
+		GetXYFromTileIndex(FromX, FromY, From);
+		GetXYFromTileIndex(ToX, ToY, To);
+		const int32 XDiff = FMath::Abs(FromX - ToX);
+		const int32 YDiff = FMath::Abs(FromY - ToY);
+		if (!bAllowDiagonal)
+			return CardinalCost * (XDiff + YDiff);
+		return CardinalCost * (XDiff + YDiff) + (DiagonalCost - 2 * CardinalCost) * FMath::Min(XDiff, YDiff);
 	};
-	SearchDirs ValidDirLookup[9] = {
-		{eDir::North, {eDir::East, eDir::Northeast, eDir::North, eDir::Northwest, eDir::West}},
-		{eDir::South, {eDir::West, eDir::Southwest, eDir::South, eDir::Southeast, eDir::East}},
-		{eDir::West,  {eDir::North, eDir::Northwest, eDir::West, eDir::Southwest, eDir::South}},
-		{eDir::East,  {eDir::South, eDir::Southeast, eDir::East, eDir::Northeast, eDir::North}},
-	    {eDir::Northwest, {eDir::North, eDir::Northwest, eDir::West}},
-		{eDir::Northeast, {eDir::East, eDir::Northeast, eDir::North}},
-		{eDir::Southwest, {eDir::West, eDir::Southwest, eDir::South }},
-		{eDir::Southeast, {eDir::South, eDir::Southeast, eDir::East }},
-		{eDir::Nil, {eDir::North,eDir::South,eDir::West,eDir::East,eDir::Northwest,eDir::Northeast,eDir::Southwest,eDir::Southeast}}
+
+	const int32 NumTiles = GetNumTiles();
+	ForwardFrontier.Prepare(NumTiles);
+	BackwardFrontier.Prepare(NumTiles);
+
+	FFrontier* Frontiers[2] = {&ForwardFrontier, &BackwardFrontier};
+	const int32 Targets[2] = {Goal, Start};
+
+	ForwardFrontier.G[Start] = 0;
+	ForwardFrontier.OpenQueue.PrioritisedAdd(Start, Heuristic(Start, Goal));
+	BackwardFrontier.G[Goal] = 0;
+	BackwardFrontier.OpenQueue.PrioritisedAdd(Goal, Heuristic(Goal, Start));
+
+	// Best path found so far goes through MeetTile and costs BestCost
+	int32 BestCost = MAX_int32;
+	int32 MeetTile = Start == Goal ? Start : -1;
+	if (Start == Goal)
+		BestCost = 0;
+
+	/*
+	* Any path cheaper than BestCost has to go through a tile still open on either side with f below BestCost,
+	* so once one side's best f reaches BestCost nothing better can turn up.
+	*/
+	auto IsDone = [&]()-> bool
+	{
+		for (FFrontier* Frontier : Frontiers)
+		{
+			if (Frontier->OpenQueue.Num() == 0 || Frontier->OpenQueue.TopPriority() >= BestCost)
+				return true;
+		}
+		return false;
 	};
 
-	auto ManhattanDist = [](IVec2 a, IVec2 b)-> int32
-	{		
-		const int32 XDiff = FMath::Abs(a.x - b.x);
-		const int32 YDiff = FMath::Abs(a.y - b.y);
-		return XDiff + YDiff;
+	auto Expand = [&](int32 Side, int32 MaxExpansions, int32 CostLimit)
+	{
+		FFrontier& Frontier = *Frontiers[Side];
+		for (int32 Expansion = 0; Expansion < MaxExpansions; ++Expansion)
+		{
+			if (Frontier.OpenQueue.Num() == 0 || Frontier.OpenQueue.TopPriority() >= CostLimit)
+				return;
+
+			const int32 CurrentTileIdx = Frontier.OpenQueue.PopFirst();
+			Frontier.Closed[CurrentTileIdx] = true;
+
+			int32 TileX, TileY;
+			GetXYFromTileIndex(TileX, TileY, CurrentTileIdx);
+
+			for (int i = 0; i < NumDirections; ++i)
+			{
+				const IVec2 Dir = FFGPathGrid::Directions[i];
+				if (PathGrid.ObstacleGrid.IsBlocked(TileX + Dir.x, TileY + Dir.y))
+					continue;
+				if (Dir.IsDiagonal() && (PathGrid.ObstacleGrid.IsBlocked(TileX + Dir.x, TileY) || PathGrid.ObstacleGrid.IsBlocked(TileX, TileY + Dir.y)))
+					continue;
+
+				const int32 NeighborIdx = (TileY + Dir.y) * Width + TileX + Dir.x;
+				if (Frontier.Closed[NeighborIdx])
+					continue;
+
+				const int32 NewGScore = Frontier.G[CurrentTileIdx] + (Dir.IsDiagonal() ? DiagonalCost : CardinalCost);
+				if (NewGScore >= Frontier.G[NeighborIdx])
+					continue;
+
+				Frontier.G[NeighborIdx] = NewGScore;
+				Frontier.Parent[NeighborIdx] = CurrentTileIdx;
+				Frontier.Touched.Add(NeighborIdx);
+
+				const int32 FScore = NewGScore + Heuristic(NeighborIdx, Targets[Side]);
+				if (Frontier.OpenQueue.Contains(NeighborIdx))
+					Frontier.OpenQueue.UpdatePriority(NeighborIdx, FScore);
+				else
+					Frontier.OpenQueue.PrioritisedAdd(NeighborIdx, FScore);
+			}
+		}
 	};
 
-	int32 GoalX,GoalY;
-	GetXYFromTileIndex(GoalX,GoalY, Goal);
-	IVec2 GoalXY = {GoalX, GoalY};
-	
-	int32 StartX, StartY;
-	GetXYFromTileIndex(StartX, StartY, Start);
-	IVec2 StartXY = {StartX, StartY};
-	
-	PriorityQueue<int32> OpenQueue;
-	OpenQueue.PrioritisedAdd(Start, ManhattanDist(StartXY,GoalXY));
+	// Only reads both sides when neither is expanding, that keeps the parallel mode free of races
+	auto CheckMeetings = [&]()
+	{
+		for (int32 Side = 0; Side < 2; ++Side)
+		{
+			const FFrontier& Other = *Frontiers[1 - Side];
+			for (const int32 TileIdx : Frontiers[Side]->Touched)
+			{
+				if (Other.G[TileIdx] == MAX_int32)
+					continue;
 
-	struct FTileData
+				const int32 Cost = ForwardFrontier.G[TileIdx] + BackwardFrontier.G[TileIdx];
+				if (Cost < BestCost)
+				{
+					BestCost = Cost;
+					MeetTile = TileIdx;
+				}
+			}
+			Frontiers[Side]->Touched.Reset();
+		}
+	};
+
+	if (bParallel)
+	{
+		constexpr int32 ExpansionsPerRound = 64;
+		while (!IsDone())
+		{
+			const int32 CostLimit = BestCost;
+			ParallelFor(2, [&Expand, CostLimit](int32 Side)
+			{
+				Expand(Side, ExpansionsPerRound, CostLimit);
+			});
+			CheckMeetings();
+		}
+	}
+	else
 	{
-		TArray<int32> GScores = TArray<int32>();
-		TArray<int32> FScores = TArray<int32>();
-		TArray<int32> Parent = TArray<int32>();
-	} TileData;
+		while (!IsDone())
+		{
+			// grow the smaller frontier, keeps both sides about the same size
+			const int32 Side = ForwardFrontier.OpenQueue.Num() <= BackwardFrontier.OpenQueue.Num() ? 0 : 1;
+			Expand(Side, 1, BestCost);
+			CheckMeetings();
+		}
+	}
+
+	if (MeetTile == -1)
+		return EFGPathStatus::NoPath;
+
+	BidirectionalMeetTile = MeetTile;
+	const int32 PathLength = WriteBidirectionalPath(OutPath);
+	OutPathLength = PathLength;
+	return PathLength <= OutPath.Num() ? EFGPathStatus::Found : EFGPathStatus::Truncated;
+}
+
+void AFGGridActor::BuildFirstMoveTable()
+{
+	RebuildObstacleGrid();
+	RebuildComponentLabels();
 
 	const int32 NumTiles = GetNumTiles();
-	TileData.GScores.Init(0, NumTiles);
-	TileData.FScores.Init(0, NumTiles);
-	TileData.Parent.Init(-1, NumTiles);
-	
-	while (OpenQueue.List.Num() > 0)
+	if (NumTiles == 0)
+		return;
+
+	constexpr int32 CardinalCost = 10;
+	constexpr int32 DiagonalCost = 14;
+
+	struct FChunk
+	{
+		TArray<int32> RowRunCounts;
+		TArray<int32> RunStarts;
+		TArray<uint8> RunMoves;
+	};
+
+	struct FOpenEntry
 	{
-		int32 CurrentNode = OpenQueue.PopFirst();
-		int32 ParentNode = TileData.Parent[CurrentNode];
+		int32 Cost;
+		int32 Tile;
 
-		int32 CurrentX, CurrentY;
-		GetXYFromTileIndex(CurrentX, CurrentY, CurrentNode);
+		bool operator<(const FOpenEntry& Other) const { return Cost < Other.Cost; }
+	};
 
-		//DrawDebugBox(GetWorld(), GetWorldLocationFromXY(CurrentX, CurrentY), FVector(50.f), FColor::Red, true, 1, 0, 10);
+	constexpr int32 SourcesPerChunk = 64;
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumTiles, SourcesPerChunk);
+	TArray<FChunk> Chunks;
+	Chunks.SetNum(NumChunks);
 
-		
-		if (CurrentNode == Goal)
-		{			
-			auto path = ConstructPath(TileData.Parent, CurrentNode);
-			VisualizePath(path, TileData.GScores);
-			return path;
+	ParallelFor(NumChunks, [this, &Chunks, NumTiles](int32 ChunkIdx)
+	{
+		FChunk& Chunk = Chunks[ChunkIdx];
+		TArray<int32> Costs;
+		TArray<uint8> FirstMoves;
+		TArray<FOpenEntry> OpenHeap;
+
+		const int32 FirstSource = ChunkIdx * SourcesPerChunk;
+		const int32 LastSource = FMath::Min(FirstSource + SourcesPerChunk, NumTiles);
+		for (int32 Source = FirstSource; Source < LastSource; ++Source)
+		{
+			Costs.Init(MAX_int32, NumTiles);
+			FirstMoves.Init(eDir::Nil, NumTiles);
+
+			if (!PathGrid.ObstacleGrid.IsBlocked(Source))
+			{
+				Costs[Source] = 0;
+				OpenHeap.Reset();
+				OpenHeap.HeapPush(FOpenEntry{0, Source});
+
+				while (OpenHeap.Num() > 0)
+				{
+					FOpenEntry Current;
+					OpenHeap.HeapPop(Current);
+					if (Current.Cost > Costs[Current.Tile])
+						continue;
+
+					const int32 TileX = Current.Tile % Width;
+					const int32 TileY = Current.Tile / Width;
+					for (int i = 0; i < 8; ++i)
+					{
+						const IVec2 Dir = FFGPathGrid::Directions[i];
+						if (PathGrid.ObstacleGrid.IsBlocked(TileX + Dir.x, TileY + Dir.y))
+							continue;
+						if (Dir.IsDiagonal() && (PathGrid.ObstacleGrid.IsBlocked(TileX + Dir.x, TileY) || PathGrid.ObstacleGrid.IsBlocked(TileX, TileY + Dir.y)))
+							continue;
+
+						const int32 NeighborIdx = (TileY + Dir.y) * Width + TileX + Dir.x;
+						const int32 NewCost = Current.Cost + (Dir.IsDiagonal() ? DiagonalCost : CardinalCost);
+						if (NewCost >= Costs[NeighborIdx])
+							continue;
+
+						Costs[NeighborIdx] = NewCost;
+						FirstMoves[NeighborIdx] = Current.Tile == Source ? static_cast<uint8>(i) : FirstMoves[Current.Tile];
+						OpenHeap.HeapPush(FOpenEntry{NewCost, NeighborIdx});
+					}
+				}
+			}
+
+			int32 NumRuns = 0;
+			uint8 CurrentMove = eDir::Nil;
+			for (int32 Target = 0; Target < NumTiles; ++Target)
+			{
+				const uint8 Move = FirstMoves[Target];
+				if (Move == eDir::Nil || Move == CurrentMove)
+					continue;
+
+				// whatever couldn't be reached before the first run might as well belong to it
+				Chunk.RunStarts.Add(NumRuns == 0 ? 0 : Target);
+				Chunk.RunMoves.Add(Move);
+				CurrentMove = Move;
+				++NumRuns;
+			}
+
+			if (NumRuns == 0)
+			{
+				Chunk.RunStarts.Add(0);
+				Chunk.RunMoves.Add(eDir::Nil);
+				NumRuns = 1;
+			}
+			Chunk.RowRunCounts.Add(NumRuns);
 		}
-			
+	});
+
+	Modify();
 
-		//Get Travel direction from parent
-		IVec2 TravelDirection;		
-		if (TileData.Parent[CurrentNode] == -1)
+	FirstMoveTable.Width = Width;
+	FirstMoveTable.Height = Height;
+	FirstMoveTable.ObstacleHash = PathGrid.ObstacleGrid.Hash;
+	FirstMoveTable.RowOffsets.Reset(NumTiles + 1);
+	FirstMoveTable.RunStarts.Reset();
+	FirstMoveTable.RunMoves.Reset();
+
+	FirstMoveTable.RowOffsets.Add(0);
+	for (const FChunk& Chunk : Chunks)
+	{
+		for (const int32 RowRunCount : Chunk.RowRunCounts)
 		{
-			TravelDirection = {0,0};
+			FirstMoveTable.RowOffsets.Add(FirstMoveTable.RowOffsets.Last() + RowRunCount);
 		}
-		else
-		{			
-			int32 ParentX, ParentY;
-			GetXYFromTileIndex(ParentX, ParentY, TileData.Parent[CurrentNode]);
-			
-			const int32 DX = FMath::Clamp(CurrentX-ParentX,-1,1);
-			const int32 DY = FMath::Clamp(CurrentY-ParentY,-1,1);
-			TravelDirection = {DX, DY};			
+		FirstMoveTable.RunStarts.Append(Chunk.RunStarts);
+		FirstMoveTable.RunMoves.Append(Chunk.RunMoves);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s: first move table for %d tiles, %d runs"), *GetName(), NumTiles, FirstMoveTable.RunMoves.Num());
+}
+
+void AFGGridActor::ImportObstacles()
+{
+	if (IsReplicatedClient())
+		return;
+
+	FString Path = ObstacleImport.File.FilePath;
+	if (FPaths::IsRelative(Path))
+		Path = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), Path);
+
+	FFGObstacleImportRules Rules;
+	Rules.BlockAbove = ObstacleImport.BlockAbove;
+	Rules.BlockBelow = ObstacleImport.BlockBelow;
+	Rules.MaxStep = ObstacleImport.MaxStep;
+
+	const int32 RowsPerChunk = FMath::Max(ObstacleImport.RowsPerChunk, 1);
+	TUniquePtr<FFGObstacleImporter> Importer;
+
+	const FString Extension = FPaths::GetExtension(Path).ToLower();
+	if (Extension == TEXT("r16") || Extension == TEXT("raw"))
+	{
+		TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+		if (!File.IsValid())
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s: could not open %s"), *GetName(), *Path);
+			return;
+		}
+
+		const int64 NumPixels = File->Size() / sizeof(uint16);
+		const int32 PixelWidth = ObstacleImport.RawWidth > 0 ? ObstacleImport.RawWidth : FMath::FloorToInt(FMath::Sqrt(static_cast<float>(NumPixels)));
+		const int32 PixelHeight = PixelWidth > 0 ? static_cast<int32>(NumPixels / PixelWidth) : 0;
+		if (PixelHeight <= 0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s: %s is too small for a %d pixel wide heightmap"), *GetName(), *Path, PixelWidth);
+			return;
 		}
 
-		//get directions to check from travel direction
-		TArray<eDir> ValidDirections;
-		for (int i = 0; i < 9; ++i)
+		Importer = MakeUnique<FFGObstacleImporter>(Width, Height, PixelWidth, PixelHeight, Rules);
+
+		// every platform we ship on is little endian, same as the file
+		TArray<uint16> Chunk;
+		for (int32 Row = 0; Row < PixelHeight; Row += RowsPerChunk)
 		{
-			if (Directions[ValidDirLookup[i].TravelDir] == TravelDirection)
+			const int32 NumRows = FMath::Min(RowsPerChunk, PixelHeight - Row);
+			Chunk.SetNumUninitialized(NumRows * PixelWidth, false);
+			if (!File->Read(reinterpret_cast<uint8*>(Chunk.GetData()), Chunk.Num() * sizeof(uint16)))
 			{
-				ValidDirections = ValidDirLookup[i].ValidDirs;
-				break;
-			}		
+				UE_LOG(LogTemp, Error, TEXT("%s: could not read %s"), *GetName(), *Path);
+				return;
+			}
+			Importer->AddPixelRows(Chunk);
+		}
+	}
+	else
+	{
+		TArray<uint8> Compressed;
+		if (!FFileHelper::LoadFileToArray(Compressed, *Path))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s: could not open %s"), *GetName(), *Path);
+			return;
 		}
-		
 
-		for (auto ValidDirection : ValidDirections)
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+		const EImageFormat Format = ImageWrapperModule.DetectImageFormat(Compressed.GetData(), Compressed.Num());
+		const TSharedPtr<IImageWrapper> ImageWrapper = Format != EImageFormat::Invalid ? ImageWrapperModule.CreateImageWrapper(Format) : nullptr;
+		if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(Compressed.GetData(), Compressed.Num()))
 		{
-			int32 newSuccessor = -1;
-			float givenCost = 0;
-			
-			IVec2 DirectionVector = Directions[ValidDirection];
-			
-			
+			UE_LOG(LogTemp, Error, TEXT("%s: %s is no image we can read"), *GetName(), *Path);
+			return;
+		}
+		Compressed.Empty();
 
-			
-			IVec2 CurrentXY = {CurrentX, CurrentY};
-			IVec2 GoalDiff = GoalXY - CurrentXY;
-		
-			bool GoalInExactDirection = false;
-			bool GoalInGeneralDirection = false;
-			IVec2 GoalDir = {FMath::Clamp(GoalDiff.x, -1, 1),
-                       FMath::Clamp(GoalDiff.y, -1, 1)};
-			if (GoalDiff.x == 0 || GoalDiff.y == 0 || FMath::Abs(GoalDiff.x) == FMath::Abs(GoalDiff.y)) // cardinal or diagonal
-			{				
-				if (GoalDir == DirectionVector)
+		const int32 PixelWidth = ImageWrapper->GetWidth();
+		const int32 PixelHeight = ImageWrapper->GetHeight();
+
+		// 16 bit gray where the format has it, otherwise 8 bit gray or color turned into brightness
+		TArray<uint8> Raw;
+		int32 BytesPerPixel = 2;
+		if (!ImageWrapper->GetRaw(ERGBFormat::Gray, 16, Raw))
+		{
+			BytesPerPixel = 1;
+			if (!ImageWrapper->GetRaw(ERGBFormat::Gray, 8, Raw))
+			{
+				BytesPerPixel = 4;
+				if (!ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, Raw))
 				{
-					GoalInExactDirection = true;
-					GoalInGeneralDirection = true;
+					UE_LOG(LogTemp, Error, TEXT("%s: could not decode %s"), *GetName(), *Path);
+					return;
 				}
 			}
-			else 
+		}
+
+		Importer = MakeUnique<FFGObstacleImporter>(Width, Height, PixelWidth, PixelHeight, Rules);
+
+		TArray<uint16> Chunk;
+		for (int32 Row = 0; Row < PixelHeight; Row += RowsPerChunk)
+		{
+			const int32 NumRows = FMath::Min(RowsPerChunk, PixelHeight - Row);
+			const int32 FirstPixel = Row * PixelWidth;
+			Chunk.SetNumUninitialized(NumRows * PixelWidth, false);
+			for (int32 Pixel = 0; Pixel < Chunk.Num(); ++Pixel)
 			{
-				if (GoalDir == DirectionVector)
-					GoalInGeneralDirection = true;
+				const uint8* Source = Raw.GetData() + static_cast<int64>(FirstPixel + Pixel) * BytesPerPixel;
+				if (BytesPerPixel == 2)
+					Chunk[Pixel] = *reinterpret_cast<const uint16*>(Source);
+				else if (BytesPerPixel == 1)
+					Chunk[Pixel] = Source[0] * 257;
+				else
+					Chunk[Pixel] = (Source[2] * 54 + Source[1] * 183 + Source[0] * 19) * 257 / 256;
 			}
-						
-			const int32 DistanceToGoal = ManhattanDist(CurrentXY, GoalXY);
-			const int32 DistanceOfThisDirection = FMath::Abs(TileList[CurrentNode].DirectionValues[ValidDirection]);
-			if(DirectionVector.IsCardinal() && GoalInExactDirection
-				&& DistanceToGoal <= DistanceOfThisDirection)
+			Importer->AddPixelRows(Chunk);
+		}
+	}
+
+	if (!Importer->IsComplete())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: %s ended early"), *GetName(), *Path);
+		return;
+	}
+
+	Modify();
+
+	const TBitArray<>& Blocked = Importer->GetBlockedTiles();
+	ImportedSize = FIntPoint(Width, Height);
+	ImportedBlocks.Init(0, FMath::DivideAndRoundUp(GetNumTiles(), 32));
+	for (TConstSetBitIterator<> It(Blocked); It; ++It)
+	{
+		ImportedBlocks[It.GetIndex() >> 5] |= 1u << (It.GetIndex() & 31);
+	}
+
+	UpdateBlockingTiles();
+
+	UE_LOG(LogTemp, Log, TEXT("%s: imported %d blocked tiles from %s"), *GetName(), Importer->GetNumBlocked(), *Path);
+}
+
+void AFGGridActor::ClearImportedObstacles()
+{
+	if (ImportedBlocks.Num() == 0)
+		return;
+
+	Modify();
+	ImportedBlocks.Empty();
+	ImportedSize = FIntPoint::ZeroValue;
+	UpdateBlockingTiles();
+}
+
+bool AFGGridActor::IsImportedBlock(int32 TileIndex) const
+{
+	return ImportedSize == FIntPoint(Width, Height) && ImportedBlocks.IsValidIndex(TileIndex >> 5)
+		&& ((ImportedBlocks[TileIndex >> 5] >> (TileIndex & 31)) & 1) != 0;
+}
+
+void AFGGridActor::ClearFirstMoveTable()
+{
+	Modify();
+	FirstMoveTable = FFGFirstMoveTable();
+}
+
+bool AFGGridActor::IsFirstMoveTableValid() const
+{
+	return !FirstMoveTable.IsEmpty()
+		&& FirstMoveTable.Width == Width && FirstMoveTable.Height == Height
+		&& FirstMoveTable.RowOffsets.Num() == GetNumTiles() + 1
+		&& FirstMoveTable.ObstacleHash == PathGrid.ObstacleGrid.Hash;
+}
+
+TArray<int32> AFGGridActor::FirstMoveTablePath(int32 Start, int32 Goal)
+{
+	TArray<int32> path;
+	if (CanWalkFirstMoveTable(Start, Goal) != EFGPathStatus::Found)
+		return path;
+
+	// the Chebyshev distance is the exact length on open ground, detours just grow the array
+	int32 StartX, StartY, GoalX, GoalY;
+	GetXYFromTileIndex(StartX, StartY, Start);
+	GetXYFromTileIndex(GoalX, GoalY, Goal);
+	path.Reserve(FMath::Max(FMath::Abs(StartX - GoalX), FMath::Abs(StartY - GoalY)) + 1);
+
+	int32 Current = Start;
+	while (true)
+	{
+		path.Add(Current);
+		if (Current == Goal)
+			return path;
+
+		Current = GetFirstMoveTableStep(Current, Goal);
+		if (Current == -1 || path.Num() > GetNumTiles())
+			return TArray<int32>();
+	}
+}
+
+EFGPathStatus AFGGridActor::FirstMoveTablePathInto(int32 Start, int32 Goal, TArrayView<int32> OutPath,
+                                                   int32& OutPathLength) const
+{
+	OutPathLength = 0;
+	const EFGPathStatus Status = CanWalkFirstMoveTable(Start, Goal);
+	if (Status != EFGPathStatus::Found)
+		return Status;
+
+	int32 PathLength = 0;
+	int32 Current = Start;
+	while (true)
+	{
+		if (PathLength < OutPath.Num())
+			OutPath[PathLength] = Current;
+		++PathLength;
+
+		if (Current == Goal)
+			break;
+
+		Current = GetFirstMoveTableStep(Current, Goal);
+		if (Current == -1 || PathLength > GetNumTiles())
+			return EFGPathStatus::NoPath;
+	}
+
+	OutPathLength = PathLength;
+	return PathLength <= OutPath.Num() ? EFGPathStatus::Found : EFGPathStatus::Truncated;
+}
+
+EFGPathStatus AFGGridActor::CanWalkFirstMoveTable(int32 Start, int32 Goal) const
+{
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal))
+		return EFGPathStatus::InvalidTiles;
+
+	if (!IsFirstMoveTableValid())
+		return EFGPathStatus::MissingData;
+
+	// the table has moves for unreachable targets too, they just lead nowhere
+	if (PathGrid.ObstacleGrid.IsBlocked(Start) || PathGrid.ObstacleGrid.IsBlocked(Goal) || !PathGrid.ComponentLabels4.AreConnected(Start, Goal))
+		return EFGPathStatus::NoPath;
+
+	return EFGPathStatus::Found;
+}
+
+int32 AFGGridActor::GetFirstMoveTableStep(int32 Tile, int32 Goal) const
+{
+	const uint8 Move = FirstMoveTable.GetFirstMove(Tile, Goal);
+	if (Move >= eDir::Nil)
+		return -1;
+
+	return Tile + FFGPathGrid::Directions[Move].y * Width + FFGPathGrid::Directions[Move].x;
+}
+
+void AFGGridActor::SetTileCost(int32 TileIndex, uint8 Cost)
+{
+	if (!IsTileIndexValid(TileIndex))
+		return;
+
+	FitTileCosts();
+
+	Cost = FMath::Max<uint8>(Cost, 1);
+	TileCosts[TileIndex] = Cost;
+	if (PathGrid.Width == Width && PathGrid.Height == Height)
+	{
+		PathGrid.CostGrid.SetCost(TileIndex % Width, TileIndex / Width, Cost, PathGrid.ObstacleGrid);
+		MarkPathGridDirty();
+	}
+}
+
+uint8 AFGGridActor::GetTileCost(int32 TileIndex) const
+{
+	if (TileCostsSize != FIntPoint(Width, Height) || !TileCosts.IsValidIndex(TileIndex))
+		return 1;
+
+	return FMath::Max<uint8>(TileCosts[TileIndex], 1);
+}
+
+void AFGGridActor::FitTileCosts()
+{
+	if (TileCostsSize == FIntPoint(Width, Height) && TileCosts.Num() == GetNumTiles())
+		return;
+
+	TileCosts.Init(1, GetNumTiles());
+	TileCostsSize = FIntPoint(Width, Height);
+}
+
+void AFGGridActor::SetTileCostInArea(const FVector& Origin, const FVector& Extent, uint8 Cost)
+{
+	TArray<int32> AreaTiles;
+	GetOverlappingTiles(Origin, Extent, AreaTiles);
+	for (const int32 TileIndex : AreaTiles)
+	{
+		SetTileCost(TileIndex, Cost);
+	}
+}
+
+TArray<int32> AFGGridActor::WeightedAStar(int32 Start, int32 Goal)
+{
+	int32 PathLength = 0;
+	WeightedAStarInto(Start, Goal, TArrayView<int32>(), PathLength);
+	return CopyScratchPath(Goal, PathLength);
+}
+
+EFGPathStatus AFGGridActor::WeightedAStarInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength)
+{
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		RebuildObstacleGrid();
+
+	return WeightedAStarInto(Start, Goal, OutPath, OutPathLength, SearchScratch);
+}
+
+EFGPathStatus AFGGridActor::WeightedAStarInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+                                              FSearchScratch& Scratch) const
+{
+	OutPathLength = 0;
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal))
+		return EFGPathStatus::InvalidTiles;
+
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		return EFGPathStatus::MissingData;
+
+	if (IsGoalUnreachable(Start, Goal) || PathGrid.ObstacleGrid.IsBlocked(Goal))
+		return EFGPathStatus::NoPath;
+
+	// octile distance over the cheapest tile there is, never more than the real cost
+	Scratch.Prepare(GetNumTiles());
+	const TFGEightNeighborhood<true> Neighborhood{PathGrid.ObstacleGrid, &PathGrid.CostGrid};
+	TFGOctileHeuristic<> Heuristic{Width, Goal % Width, Goal / Width};
+	Heuristic.Scale = PathGrid.CostGrid.MinCost;
+	if (!RunGridSearch(Neighborhood, Heuristic, Start, Goal, Scratch))
+		return EFGPathStatus::NoPath;
+
+	return ConstructPathInto(Scratch.Parent, Goal, OutPath, OutPathLength);
+}
+
+const FFGReachableTiles& AFGGridActor::GetReachableTiles(int32 Origin, int32 Budget)
+{
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		RebuildObstacleGrid();
+
+	// publishes pending edits first, so the version says exactly which grid a result is for
+	const FFGPathGridSnapshot Snapshot = AcquirePathGridSnapshot();
+	const uint32 GridVersion = Snapshot.IsValid() ? Snapshot->Version : 0;
+
+	for (int32 Index = ReachableCache.Num() - 1; Index >= 0; --Index)
+	{
+		const FFGReachableTiles& Cached = ReachableCache[Index];
+		if (Cached.Origin == Origin && Cached.Budget == Budget && Cached.GridVersion == GridVersion)
+		{
+			if (Index != ReachableCache.Num() - 1)
 			{
-				newSuccessor = Goal;
-				givenCost = DistanceToGoal + TileData.GScores[CurrentNode];
+				FFGReachableTiles Hit = MoveTemp(ReachableCache[Index]);
+				ReachableCache.RemoveAt(Index, 1, false);
+				ReachableCache.Add(MoveTemp(Hit));
 			}
-			else  /*&& goal is in general direction see text about middle conditional*/
+			return ReachableCache.Last();
+		}
+	}
+
+	FFGReachableTiles Result;
+	if (ReachableCache.Num() >= FMath::Max(1, ReachableCacheSize))
+	{
+		Result = MoveTemp(ReachableCache[0]);
+		ReachableCache.RemoveAt(0, 1, false);
+	}
+
+	if (Snapshot.IsValid())
+		Snapshot->ComputeReachableTiles(Origin, Budget, RangeScratch, Result);
+	else
+		PathGrid.ComputeReachableTiles(Origin, Budget, RangeScratch, Result);
+
+	ReachableCache.Add(MoveTemp(Result));
+	return ReachableCache.Last();
+}
+
+TArray<int32> AFGGridActor::GetPreviewPath(int32 Start, int32 Goal)
+{
+	TArray<int32> Path;
+	int32 PathLength = 0;
+	if (GetPreviewPathInto(Start, Goal, TArrayView<int32>(), PathLength) == EFGPathStatus::Truncated)
+	{
+		Path.SetNumUninitialized(PathLength);
+		GetPreviewPathInto(Start, Goal, Path, PathLength);
+	}
+	return Path;
+}
+
+EFGPathStatus AFGGridActor::GetPreviewPathInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength)
+{
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		RebuildObstacleGrid();
+
+	// the tree belongs to one version of the grid, publishing pending edits first tells us which
+	const FFGPathGridSnapshot Snapshot = AcquirePathGridSnapshot();
+	const FFGPathGrid& Grid = Snapshot.IsValid() ? *Snapshot : PathGrid;
+
+	if (!PathPreview.IsRootedAt(Start, Grid.Version))
+		Grid.StartPathPreview(Start, PathPreview);
+
+	return Grid.ExtendPathPreview(PathPreview, Goal, OutPath, OutPathLength);
+}
+
+void AFGGridActor::GetMovementRange(int32 Origin, int32 Budget, TArray<int32>& OutTiles, TArray<int32>& OutCosts)
+{
+	const FFGReachableTiles& Reachable = GetReachableTiles(Origin, Budget);
+	OutTiles = Reachable.Tiles;
+	OutCosts = Reachable.Costs;
+}
+
+TArray<int32> AFGGridActor::InfluenceAStar(int32 Start, int32 Goal, FName Layer, float Weight)
+{
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		RebuildObstacleGrid();
+
+	int32 PathLength = 0;
+	InfluenceAStarInto(Start, Goal, Layer, Weight, TArrayView<int32>(), PathLength, SearchScratch);
+	return CopyScratchPath(Goal, PathLength);
+}
+
+EFGPathStatus AFGGridActor::InfluenceAStarInto(int32 Start, int32 Goal, FName Layer, float Weight,
+                                               TArrayView<int32> OutPath, int32& OutPathLength,
+                                               FSearchScratch& Scratch) const
+{
+	OutPathLength = 0;
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal))
+		return EFGPathStatus::InvalidTiles;
+
+	const FFGInfluenceLayer* InfluenceLayer = InfluenceMap.FindLayer(Layer);
+	if (PathGrid.Width != Width || PathGrid.Height != Height || InfluenceLayer == nullptr
+		|| !InfluenceMap.IsBuiltFor(Width, Height))
+		return EFGPathStatus::MissingData;
+
+	if (IsGoalUnreachable(Start, Goal) || PathGrid.ObstacleGrid.IsBlocked(Goal))
+		return EFGPathStatus::NoPath;
+
+	const float StepWeight = FMath::Max(Weight, 0.0f);
+	auto InfluenceCost = [this, InfluenceLayer, StepWeight](int32 Successor, int32 StepCost)
+	{
+		return FMath::Max(0, FMath::RoundToInt(StepCost * StepWeight * InfluenceMap.GetValue(*InfluenceLayer, Successor)));
+	};
+
+	// the extra cost is never negative, so WeightedAStar's heuristic still holds
+	Scratch.Prepare(GetNumTiles());
+	const TFGEightNeighborhood<true> Weighted{PathGrid.ObstacleGrid, &PathGrid.CostGrid};
+	const TFGCostHookNeighborhood<TFGEightNeighborhood<true>, decltype(InfluenceCost)> Neighborhood{Weighted, InfluenceCost};
+	TFGOctileHeuristic<> Heuristic{Width, Goal % Width, Goal / Width};
+	Heuristic.Scale = PathGrid.CostGrid.MinCost;
+	if (!RunGridSearch(Neighborhood, Heuristic, Start, Goal, Scratch))
+		return EFGPathStatus::NoPath;
+
+	return ConstructPathInto(Scratch.Parent, Goal, OutPath, OutPathLength);
+}
+
+void AFGGridActor::AddInfluenceLayer(FName Layer, float Falloff, float Momentum, float Decay)
+{
+	if (InfluenceMap.FindLayer(Layer) != nullptr)
+		return;
+
+	if (!InfluenceMap.IsBuiltFor(Width, Height) && PathGrid.ObstacleGrid.Width == Width && PathGrid.ObstacleGrid.Height == Height)
+		InfluenceMap.SetObstacles(PathGrid.ObstacleGrid);
+
+	FFGInfluenceLayer& NewLayer = InfluenceMap.AddLayer(Layer);
+	NewLayer.Falloff = FMath::Clamp(Falloff, 0.0f, 1.0f);
+	NewLayer.Momentum = FMath::Clamp(Momentum, 0.0f, 1.0f);
+	NewLayer.Decay = FMath::Clamp(Decay, 0.0f, 1.0f);
+	SetActorTickEnabled(true);
+}
+
+void AFGGridActor::RemoveInfluenceLayer(FName Layer)
+{
+	// Tick turns itself off when nothing else needs it
+	InfluenceMap.RemoveLayer(Layer);
+}
+
+void AFGGridActor::StampInfluence(FName Layer, const FVector& WorldLocation, float RadiusInTiles, float Strength)
+{
+	int32 TileX = 0;
+	int32 TileY = 0;
+	if (!GetXYFromWorldLocation(WorldLocation, TileX, TileY))
+		return;
+
+	FFGInfluenceStamp Stamp;
+	Stamp.X = TileX;
+	Stamp.Y = TileY;
+	Stamp.Radius = FMath::Max(RadiusInTiles, 0.0f);
+	Stamp.Strength = Strength;
+	InfluenceMap.Stamp(Layer, Stamp);
+}
+
+float AFGGridActor::GetInfluence(FName Layer, int32 TileIndex) const
+{
+	const FFGInfluenceLayer* InfluenceLayer = InfluenceMap.FindLayer(Layer);
+	if (InfluenceLayer == nullptr || !IsTileIndexValid(TileIndex) || !InfluenceMap.IsBuiltFor(Width, Height))
+		return 0.0f;
+
+	return InfluenceMap.GetValue(*InfluenceLayer, TileIndex);
+}
+
+int32 AFGGridActor::AddOccupant(AActor* Actor, int32 Type)
+{
+	if (Actor == nullptr)
+		return INDEX_NONE;
+
+	// before BeginPlay, or after a resize that didn't go through CommitTileChanges
+	if (!Occupancy.IsBuiltFor(Width, Height))
+	{
+		Occupancy.Init(Width, Height);
+		UpdateOccupants();
+	}
+
+	// same conversion UpdateOccupants uses, off the grid has to come out as INDEX_NONE and not tile 0
+	const FVector Location = Actor->GetActorLocation();
+	int32 TileIndex = INDEX_NONE;
+	GetTileIndicesFromWorldLocations(MakeArrayView(&Location, 1), MakeArrayView(&TileIndex, 1));
+
+	const int32 Handle = Occupancy.AddOccupant(TileIndex, Type);
+	if (OccupantActors.Num() <= Handle)
+		OccupantActors.SetNum(Handle + 1);
+	OccupantActors[Handle] = Actor;
+
+	Occupancy.Update();
+	SetActorTickEnabled(true);
+	return Handle;
+}
+
+void AFGGridActor::RemoveOccupant(int32 Handle)
+{
+	if (!Occupancy.IsValidOccupant(Handle))
+		return;
+
+	Occupancy.RemoveOccupant(Handle);
+	OccupantActors[Handle].Reset();
+	Occupancy.Update();
+}
+
+void AFGGridActor::UpdateOccupants()
+{
+	OccupantHandles.Reset();
+	OccupantLocations.Reset();
+	for (int32 Handle = 0; Handle < OccupantActors.Num(); ++Handle)
+	{
+		if (!Occupancy.IsValidOccupant(Handle))
+			continue;
+
+		const AActor* Actor = OccupantActors[Handle].Get();
+		if (Actor == nullptr)
+		{
+			Occupancy.RemoveOccupant(Handle);
+			continue;
+		}
+
+		OccupantHandles.Add(Handle);
+		OccupantLocations.Add(Actor->GetActorLocation());
+	}
+
+	OccupantTiles.SetNumUninitialized(OccupantLocations.Num(), false);
+	GetTileIndicesFromWorldLocations(OccupantLocations, OccupantTiles);
+	for (int32 Index = 0; Index < OccupantHandles.Num(); ++Index)
+	{
+		Occupancy.MoveOccupant(OccupantHandles[Index], OccupantTiles[Index]);
+	}
+
+	Occupancy.Update();
+}
+
+TArray<AActor*> AFGGridActor::GetActorsOnTile(int32 TileIndex) const
+{
+	TArray<int32> Handles;
+	Occupancy.GetOccupantsOnTile(TileIndex, Handles);
+
+	TArray<AActor*> Actors;
+	for (const int32 Handle : Handles)
+	{
+		if (AActor* Actor = OccupantActors[Handle].Get())
+			Actors.Add(Actor);
+	}
+	return Actors;
+}
+
+TArray<AActor*> AFGGridActor::GetActorsInRadius(int32 TileIndex, int32 Radius, int32 Type) const
+{
+	TArray<int32> Handles;
+	Occupancy.FindOccupantsInRadius(TileIndex, Radius, Type < 0 ? INDEX_NONE : Type, Handles);
+
+	TArray<AActor*> Actors;
+	for (const int32 Handle : Handles)
+	{
+		if (AActor* Actor = OccupantActors[Handle].Get())
+			Actors.Add(Actor);
+	}
+	return Actors;
+}
+
+AActor* AFGGridActor::FindNearestActorOfType(int32 TileIndex, int32 Type, int32 MaxRadius) const
+{
+	const int32 Handle = Occupancy.FindNearestOccupant(TileIndex, Type < 0 ? INDEX_NONE : Type, MaxRadius);
+	return Handle != INDEX_NONE ? OccupantActors[Handle].Get() : nullptr;
+}
+
+int32 AFGGridActor::FindNearestFreeTile(int32 TileIndex, int32 MaxRadius, bool bAllowOccupied) const
+{
+	return Occupancy.FindNearestFreeTile(PathGrid.ObstacleGrid, TileIndex, MaxRadius, bAllowOccupied);
+}
+
+TArray<int32> AFGGridActor::WeightedJPS(int32 Start, int32 Goal)
+{
+	int32 PathLength = 0;
+	WeightedJPSInto(Start, Goal, TArrayView<int32>(), PathLength);
+	return CopyScratchPath(Goal, PathLength);
+}
+
+EFGPathStatus AFGGridActor::WeightedJPSInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength)
+{
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		RebuildObstacleGrid();
+
+	return WeightedJPSInto(Start, Goal, OutPath, OutPathLength, SearchScratch);
+}
+
+EFGPathStatus AFGGridActor::WeightedJPSInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+                                            FSearchScratch& Scratch) const
+{
+	OutPathLength = 0;
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal))
+		return EFGPathStatus::InvalidTiles;
+
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		return EFGPathStatus::MissingData;
+
+	if (IsGoalUnreachable(Start, Goal) || PathGrid.ObstacleGrid.IsBlocked(Goal))
+		return EFGPathStatus::NoPath;
+
+	Scratch.Prepare(GetNumTiles());
+	const FFGWeightedJumpNeighborhood Neighborhood{PathGrid, Goal};
+	TFGOctileHeuristic<> Heuristic{Width, Goal % Width, Goal / Width};
+	Heuristic.Scale = PathGrid.CostGrid.MinCost;
+	if (!RunGridSearch(Neighborhood, Heuristic, Start, Goal, Scratch))
+		return EFGPathStatus::NoPath;
+
+	return ConstructPathInto(Scratch.Parent, Goal, OutPath, OutPathLength);
+}
+
+void AFGGridActor::ComputeTravelCosts(int32 Source, TArray<int32>& OutCosts) const
+{
+	if (!IsTileIndexValid(Source) || PathGrid.Width != Width || PathGrid.Height != Height)
+	{
+		OutCosts.Init(MAX_int32, GetNumTiles());
+		return;
+	}
+
+	// no goal and no heuristic, runs until everything reachable is settled
+	FSearchScratch Scratch;
+	Scratch.Prepare(GetNumTiles());
+	const TFGEightNeighborhood<true> Neighborhood{PathGrid.ObstacleGrid, &PathGrid.CostGrid};
+	RunGridSearch(Neighborhood, FFGZeroHeuristic(), Source, INDEX_NONE, Scratch);
+	OutCosts = MoveTemp(Scratch.GScores);
+}
+
+TArray<int32> AFGGridActor::LazyThetaStar(int32 Start, int32 Goal)
+{
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal) || TileList[Start].bBlock || TileList[Goal].bBlock)
+		return TArray<int32>();
+
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		RebuildObstacleGrid();
+
+	if (IsGoalUnreachable(Start, Goal))
+		return TArray<int32>();
+
+	auto Distance = [this](int32 A, int32 B)-> float
+	{
+		int32 AX, AY, BX, BY;
+		GetXYFromTileIndex(AX, AY, A);
+		GetXYFromTileIndex(BX, BY, B);
+		return FMath::Sqrt(static_cast<float>(FMath::Square(AX - BX) + FMath::Square(AY - BY)));
+	};
+
+	// Diagonal moves need both cardinal tiles beside them to be free, same rule as the JPS diagonal sweep
+	auto CanStep = [this](int32 X, int32 Y, const IVec2& Dir)-> bool
+	{
+		if (PathGrid.ObstacleGrid.IsBlocked(X + Dir.x, Y + Dir.y))
+			return false;
+		return !Dir.IsDiagonal() || (!PathGrid.ObstacleGrid.IsBlocked(X + Dir.x, Y) && !PathGrid.ObstacleGrid.IsBlocked(X, Y + Dir.y));
+	};
+
+	struct FOpenEntry
+	{
+		float FScore;
+		int32 Tile;
+
+		bool operator<(const FOpenEntry& Other) const { return FScore < Other.FScore; }
+	};
+	TArray<FOpenEntry> OpenHeap;
+
+	const int32 NumTiles = GetNumTiles();
+	TArray<float> GScores;
+	TArray<int32> Parent;
+	TBitArray<> Closed(false, NumTiles);
+	GScores.Init(MAX_FLT, NumTiles);
+	Parent.Init(-1, NumTiles);
+
+	GScores[Start] = 0.f;
+	OpenHeap.HeapPush(FOpenEntry{Distance(Start, Goal), Start});
+
+	while (OpenHeap.Num() > 0)
+	{
+		FOpenEntry Current;
+		OpenHeap.HeapPop(Current);
+
+		const int32 Tile = Current.Tile;
+		if (Closed[Tile])
+			continue; //stale entry, the tile was reopened with a better score
+
+		int32 TileX, TileY;
+		GetXYFromTileIndex(TileX, TileY, Tile);
+
+		//SetVertex: the parent was assumed visible when queued, fall back to the best closed neighbor if it isn't
+		if (Parent[Tile] != -1 && !HasLineOfSight(Parent[Tile], Tile))
+		{
+			GScores[Tile] = MAX_FLT;
+			for (int i = 0; i < 8; ++i)
 			{
-				const int32 RowDiffToGoal = FMath::Abs(CurrentX-GoalX);
-				const int32 ColDiffToGoal = FMath::Abs(CurrentY-GoalY);
-				const bool GoalCloserThanJumpDistance =  RowDiffToGoal <= DistanceOfThisDirection
-												  || ColDiffToGoal <= DistanceOfThisDirection; 
-				if (DirectionVector.IsDiagonal() && GoalInGeneralDirection && GoalCloserThanJumpDistance)
-				{
-					int minDiff = FMath::Min(RowDiffToGoal,  ColDiffToGoal);
-					
-					GetTileIndexFromXY(CurrentX+DirectionVector.x*minDiff, CurrentY+DirectionVector.y*minDiff, newSuccessor);
-					givenCost = TileData.GScores[CurrentNode] + Sqrt2*minDiff; 
-				}
-				else if(TileList[CurrentNode].DirectionValues[ValidDirection] > 0) //there is a jump point in this direction
+				const IVec2 Dir = FFGPathGrid::Directions[i];
+				int32 NeighborIdx;
+				if (!GetTileIndexFromXY(TileX + Dir.x, TileY + Dir.y, NeighborIdx)
+					|| !Closed[NeighborIdx]
+					|| !CanStep(TileX, TileY, Dir))
+					continue;
+
+				const float NewGScore = GScores[NeighborIdx] + (Dir.IsDiagonal() ? Sqrt2 : 1.f);
+				if (NewGScore < GScores[Tile])
 				{
-					GetTileIndexFromXY(CurrentX+DirectionVector.x*DistanceOfThisDirection,
-									   CurrentY+DirectionVector.y*DistanceOfThisDirection, newSuccessor);
-					givenCost = TileData.GScores[CurrentNode];
-					if (DirectionVector.IsDiagonal())
-						givenCost += Sqrt2*DistanceOfThisDirection;
-					else
-						givenCost += DistanceOfThisDirection;
+					GScores[Tile] = NewGScore;
+					Parent[Tile] = NeighborIdx;
 				}
 			}
+		}
+
+		Closed[Tile] = true;
+
+		if (Tile == Goal)
+			return ConstructPath(Parent, Tile);
+
+		const int32 Anchor = Parent[Tile] == -1 ? Tile : Parent[Tile];
+		for (int i = 0; i < 8; ++i)
+		{
+			const IVec2 Dir = FFGPathGrid::Directions[i];
+			int32 NeighborIdx;
+			if (!GetTileIndexFromXY(TileX + Dir.x, TileY + Dir.y, NeighborIdx)
+				|| Closed[NeighborIdx]
+				|| !CanStep(TileX, TileY, Dir))
+				continue;
 
-			if (newSuccessor != -1)
+			const float NewGScore = GScores[Anchor] + Distance(Anchor, NeighborIdx);
+			if (NewGScore < GScores[NeighborIdx])
 			{
-				if (givenCost < TileData.GScores[newSuccessor] || TileData.GScores[newSuccessor] == 0)
-				{
-					TileData.Parent[newSuccessor] = CurrentNode;
-					TileData.GScores[newSuccessor] = givenCost;
-					TileData.FScores[newSuccessor] = givenCost + DistanceToGoal;
-					if (OpenQueue.Contains(newSuccessor))
-						OpenQueue.UpdatePriority(newSuccessor, TileData.FScores[newSuccessor]);
-					else
-						OpenQueue.PrioritisedAdd(newSuccessor, TileData.FScores[newSuccessor]);
-				}
+				GScores[NeighborIdx] = NewGScore;
+				Parent[NeighborIdx] = Anchor;
+				OpenHeap.HeapPush(FOpenEntry{NewGScore + Distance(NeighborIdx, Goal), NeighborIdx});
 			}
-		}		
+		}
 	}
 	return TArray<int32>();
-};
+}
 
+TArray<int32> AFGGridActor::JPSRuntime(int32 Start, int32 Goal)
+{
+	int32 PathLength = 0;
+	JPSRuntimeInto(Start, Goal, TArrayView<int32>(), PathLength);
+	return CopyScratchPath(Goal, PathLength);
+}
 
+EFGPathStatus AFGGridActor::JPSRuntimeInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength)
+{
+	if (!PathGrid.HasJumpData() || PathGrid.Width != Width || PathGrid.Height != Height)
+		JPSPreProcess();
+
+	return JPSRuntimeInto(Start, Goal, OutPath, OutPathLength, SearchScratch);
+}
+
+EFGPathStatus AFGGridActor::JPSRuntimeInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+                                           FSearchScratch& Scratch) const
+{
+	OutPathLength = 0;
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal))
+		return EFGPathStatus::InvalidTiles;
+
+	if (PathGrid.Width != Width || PathGrid.Height != Height)
+		return EFGPathStatus::MissingData;
+
+	return PathGrid.JPSRuntime(Start, Goal, OutPath, OutPathLength, Scratch);
+}
@@ -1,76 +1,126 @@
 #pragma once
 
 #include "GameFramework/Actor.h"
+#include "FGAI_2Core/FGPathGrid.h"
+#include "FGAI_2Core/PriorityQueue.h"
+#include "FGAI_2Core/FGInfluenceMap.h"
+#include "FGAI_2Core/FGVisibility.h"
+#include "FGAI_2Core/FGOccupancyGrid.h"
+#include "FGObstacleReplication.h"
+#include "FGAI_2/Movement/FGPathFollowingManager.h"
 #include "FGGridActor.generated.h"
 
-constexpr double Sqrt2 = 1.4142135623730950488016887242097;
+UENUM(BlueprintType)
+enum class EFGConnectivity : uint8
+{
+	// Cardinal moves, and diagonal moves that don't cut corners (what all our searches do)
+	Four,
+	// Diagonal neighbors are connected even when both tiles beside the move are blocked
+	Eight,
+};
 
-struct IVec2
+USTRUCT(BlueprintType)
+struct FFGTileinfo
 {
-	int32 x,y;
+	GENERATED_BODY()
+public:
+	UPROPERTY(BlueprintReadWrite, Category = "Tile")	
+	bool bBlock = false;
+};
 
-	bool IsCardinal() const
-	{
-		return (x==0 && y!=0) || (y==0 && x!=0);
-	}
+/*
+* First move of an optimal 8-connected path (no corner cutting) from every tile to every other tile, in eDir values.
+* Each source tile gets one row over all target tiles, run-length encoded. Targets that can't be reached
+* from the source don't get a move of their own and just extend the run before them.
+*/
+USTRUCT()
+struct FFGFirstMoveTable
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY()
+	int32 Width = 0;
 
-	bool IsDiagonal() const
-	{
-		return x != 0 && y != 0;
-	}
+	UPROPERTY()
+	int32 Height = 0;
 
-	bool operator==(IVec2 other) const
-	{
-		return (other.x == x) && (other.y == y); 
-	}
+	// FFGObstacleGrid::Hash of the obstacles the table was built from
+	UPROPERTY()
+	uint64 ObstacleHash = 0;
+
+	// the runs of source tile S are [RowOffsets[S], RowOffsets[S + 1])
+	UPROPERTY()
+	TArray<int32> RowOffsets;
+
+	// first target tile each run covers
+	UPROPERTY()
+	TArray<int32> RunStarts;
 
-	IVec2 operator-(IVec2 other) const
+	UPROPERTY()
+	TArray<uint8> RunMoves;
+
+	bool IsEmpty() const { return RowOffsets.Num() == 0; }
+
+	uint8 GetFirstMove(int32 Source, int32 Target) const
 	{
-		return IVec2{x-other.x, y-other.y};
+		// last run starting at or before the target
+		int32 Low = RowOffsets[Source];
+		int32 High = RowOffsets[Source + 1] - 1;
+		while (Low < High)
+		{
+			const int32 Mid = (Low + High + 1) / 2;
+			if (RunStarts[Mid] <= Target)
+				Low = Mid;
+			else
+				High = Mid - 1;
+		}
+		return RunMoves[Low];
 	}
 };
 
-enum eDir
-{		
-	North,
-    South,
-    West,
-    East,
-    Northwest,
-    Northeast,
-    Southwest,
-    Southeast,
-	Nil,
-};
-
 /*
-const IVec2 UpLeft =		{-1,1};
-const IVec2 UpRight =	{1,1};
-const IVec2 DownLeft =	{-1,-1};
-const IVec2 DownRight = {1,-1};
-const IVec2 Up =		{0,1};
-const IVec2 Down =	{0,-1};
-const IVec2 Left =	{-1,0};
-const IVec2 Right =	{1,0};
+* Where AFGGridActor::ImportObstacles reads from and what counts as blocked, see FFGObstacleImportRules.
+* Heights go from 0 (black) to 1 (white).
 */
-
 USTRUCT(BlueprintType)
-struct FFGTileinfo
+struct FFGObstacleImportSettings
 {
 	GENERATED_BODY()
 public:
-	bool ApproachDirs[4] = { false, false, false, false};
+	/*
+	* Any image the ImageWrapper module reads (png, bmp, exr, ...) as grayscale, or a .r16/.raw heightmap
+	* (16 bit little endian, what landscapes export). Raw files are read a chunk of rows at a time.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Import")
+	FFilePath File;
 
-	int32 DirectionValues[8] = {0,0,0,0,0,0,0,0};
-	
-	UPROPERTY(BlueprintReadWrite, Category = "Tile")	
-	bool bBlock = false;
+	// raw files don't say how wide they are, 0 means square
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Import", meta = (ClampMin = 0))
+	int32 RawWidth = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Import")
+	float BlockAbove = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Import")
+	float BlockBelow = -1.0f;
+
+	// biggest height difference between neighboring tiles that can still be walked, negative for no slope rule
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Import")
+	float MaxStep = -1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Import", meta = (ClampMin = 1))
+	int32 RowsPerChunk = 256;
 };
 
 class UStaticMeshComponent;
 class UStaticMesh;
 class UStaticMeshDescription;
 
+/*
+* Broadcast by UpdateBlockingTiles with the indices of every tile whose bBlock flipped.
+*/
+DECLARE_MULTICAST_DELEGATE_OneParam(FFGOnTilesChanged, const TArray<int32>& /*ChangedTiles*/);
+
 UCLASS()
 class FGAI_2_API AFGGridActor : public AActor
 {
@@ -78,8 +128,22 @@ class FGAI_2_API AFGGridActor : public AActor
 public:
 	AFGGridActor();
 
+	/*
+	* Registers with UFGGridSubsystem, early enough that every other actor's BeginPlay can already find us.
+	*/
+	virtual void PostInitializeComponents() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	virtual void BeginPlay() override;
 
+	/*
+	* Only on while there are path followers to move, influence layers to update or occupants to track.
+	*/
+	virtual void Tick(float DeltaSeconds) override;
+
 	/*
 	* Called whenever placed in the editor or world, having its transform changed etc.
 	* Responsible for eventually calling the infamous ConstructionScript in blueprint.
@@ -117,6 +181,14 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Grid")
 	bool TransformWorldLocationToTileLocation(const FVector& InWorldLocation, FVector& OutTileWorldLocation) const;
 
+	/*
+	* Batch versions for converting lots of agents at once. The actor transform is only looked at once per call,
+	* world->tile runs four locations per SIMD step. Locations outside the grid get INDEX_NONE, invalid tiles ZeroVector.
+	* Output views need at least as many elements as the input.
+	*/
+	void GetTileIndicesFromWorldLocations(TArrayView<const FVector> WorldLocations, TArrayView<int32> OutTileIndices) const;
+	void GetWorldLocationsFromTileIndices(TArrayView<const int32> TileIndices, TArrayView<FVector> OutWorldLocations) const;
+
 	/*
 	* Returns a list of indices correlating to the location of a tile within the TileList
 	*/
@@ -124,8 +196,55 @@ public:
 
 	void DrawBlocks();
 
+	/*
+	* Recomputes TileList[].bBlock from the block components and the imported obstacles. Does nothing on
+	* network clients, they get the server's obstacles through ObstacleDeltas instead.
+	*/
 	void UpdateBlockingTiles();
 
+	UPROPERTY(EditAnywhere, Category = "Grid|Import")
+	FFGObstacleImportSettings ObstacleImport;
+
+	/*
+	* Blocks tiles straight from ObstacleImport's image or heightmap, for maps too big to build from block
+	* components. The imported tiles are kept apart from the components' and saved with the level, tiles
+	* are blocked if either says so. Block mesh, labels and jump data get rebuilt once at the end.
+	*/
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Grid|Import")
+	void ImportObstacles();
+
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Grid|Import")
+	void ClearImportedObstacles();
+
+	bool IsImportedBlock(int32 TileIndex) const;
+
+	/*
+	* Blocks or clears Tiles on the imported layer, for the editor's tile painting. Only tiles that flip get touched:
+	* the packed obstacles are patched in place and labels and clearance repaired like any small edit, tiles a block
+	* component covers stay blocked. Block mesh and jump data wait for FinishTileEdits, so a brush stroke pays for
+	* those once (JPSRuntime says MissingData until then). OutChangedTiles gets the flipped tiles appended.
+	*/
+	void PaintImportedTiles(TArrayView<const int32> Tiles, bool bBlock, TArray<int32>& OutChangedTiles);
+	void FinishTileEdits();
+
+	/*
+	* The server's obstacle changes as compact deltas, see FFGObstacleDeltaArray. Clients rebuild PathGrid
+	* and the jump data from them themselves. Transient, levels keep saving TileList.
+	*/
+	UPROPERTY(Replicated, Transient)
+	FFGObstacleDeltaArray ObstacleDeltas;
+
+	/*
+	* Client side, applies whatever replicated deltas follow the version the grid is at.
+	*/
+	void ApplyReplicatedObstacles();
+
+	/*
+	* Listeners (e.g. incremental planners) get told which tiles changed so they only have to repair those.
+	* Not broadcast when the grid is resized, listeners have to check GetNumTiles themselves.
+	*/
+	FFGOnTilesChanged OnTilesChanged;
+
 	void GenerateGrid();
 
 	bool IsWorldLocationInsideGrid(const FVector& WorldLocation) const;
@@ -143,37 +262,432 @@ public:
 		int32 Parent = -1;
 	};
 
-	IVec2 Directions[9] = {
-		{0,-1}, //North
-		{0,1},  //South
-		{-1,0}, //West
-		{1,0},  //East
-		{-1,-1},//NorthWest
-		{1,-1}, //NorthEast
-		{-1,1}, //SouthWest
-		{1,1},  //SouthEast
-		{0,0}
-	};
-
 	UFUNCTION(BlueprintCallable)
 	TArray<int32> FindPath(const int32& start, const int32& goal);
-	bool IsObstacle(int32 X, int32 Y);
+
+	/*
+	* Rebuilds the jump distances in PathGrid, the obstacles too if they don't match the grid size anymore.
+	*/
 	void JPSPreProcess();
 
 	void VisualizePath(const TArray<int32>& path, const TArray<int32>& GScores);
 	TArray<int32> ConstructPath(const TArray<int32>& Parent, const int32& Goal);
 	UFUNCTION(BlueprintCallable)
 	TArray<int32> JPSRuntime(int32 Start, int32 Goal);
-	
-	
+
+	/*
+	* What the searches built on RunGridSearch (FGSearchCore.h) keep per tile, with int32 costs.
+	*/
+	using FSearchScratch = FFGSearchScratch;
+
+	/*
+	* Native versions of the searches above. They write the path start->goal into the caller's buffer and reuse
+	* SearchScratch, so nothing gets allocated once the scratch has grown to the grid size.
+	* OutPathLength is always the full path length, if it is larger than OutPath only the first part was written.
+	* The overloads taking a scratch leave the actor alone but still read PathGrid, which the game thread edits in place.
+	* Worker threads search a snapshot from AcquirePathGridSnapshot instead, with a scratch from UFGGridSubsystem's pool.
+	*/
+	EFGPathStatus FindPathInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength);
+	EFGPathStatus FindPathInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+	                           FSearchScratch& Scratch) const;
+	EFGPathStatus JPSRuntimeInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength);
+	EFGPathStatus JPSRuntimeInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+	                             FSearchScratch& Scratch) const;
+	EFGPathStatus ConstructPathInto(const TArray<int32>& Parent, int32 Goal, TArrayView<int32> OutPath,
+	                                int32& OutPathLength) const;
+
+	/*
+	* FindPath and JPSRuntime for agents covering AgentSize x AgentSize tiles, the tiles in the path are their
+	* top left corner (lowest X and Y). Anywhere the clearance map says the agent doesn't fit counts as blocked.
+	*/
+	UFUNCTION(BlueprintCallable)
+	TArray<int32> FindPathForSize(int32 Start, int32 Goal, int32 AgentSize);
+
+	UFUNCTION(BlueprintCallable)
+	TArray<int32> JPSRuntimeForSize(int32 Start, int32 Goal, int32 AgentSize);
+
+	EFGPathStatus FindPathForSizeInto(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+	                                  int32& OutPathLength);
+	EFGPathStatus FindPathForSizeInto(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+	                                  int32& OutPathLength, FSearchScratch& Scratch) const;
+	EFGPathStatus JPSRuntimeForSizeInto(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+	                                    int32& OutPathLength);
+	EFGPathStatus JPSRuntimeForSizeInto(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+	                                    int32& OutPathLength, FSearchScratch& Scratch) const;
+
+	/*
+	* Largest agent that fits with its top left corner on the tile, 0 on blocks. Capped at FFGClearanceMap::MaxClearance.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Grid")
+	int32 GetTileClearance(int32 TileIndex) const;
+
+	FSearchScratch SearchScratch;
+
+	/*
+	* One side of BidirectionalAStar, G is MAX_int32 for tiles this side hasn't reached.
+	*/
+	struct FFrontier
+	{
+		TArray<int32> G;
+		TArray<int32> Parent;
+		TBitArray<> Closed;
+		PriorityQueue<int32> OpenQueue;
+		// tiles whose G changed since the last meeting check
+		TArray<int32> Touched;
+
+		void Prepare(int32 NumTiles);
+	};
+
+	FFrontier ForwardFrontier;
+	FFrontier BackwardFrontier;
+	// where the two frontiers of the last BidirectionalAStarInto met, -1 if they didn't
+	int32 BidirectionalMeetTile = -1;
+
+	/*
+	* Writes the path of the last bidirectional search into OutPath as far as it fits, returns the full length.
+	*/
+	int32 WriteBidirectionalPath(TArrayView<int32> OutPath) const;
+
+	/*
+	* A* from both ends at once, meeting in the middle. Costs are 10 per cardinal and 14 per diagonal step,
+	* diagonals never cut corners. bParallel runs the two frontiers on task graph workers in lock-step batches.
+	*/
+	UFUNCTION(BlueprintCallable)
+	TArray<int32> BidirectionalAStar(int32 Start, int32 Goal, bool bAllowDiagonal = false, bool bParallel = false);
+
+	EFGPathStatus BidirectionalAStarInto(int32 Start, int32 Goal, bool bAllowDiagonal, bool bParallel,
+	                                     TArrayView<int32> OutPath, int32& OutPathLength);
+
+	/*
+	* Runs a Dijkstra from every tile, in parallel, and stores the first moves in FirstMoveTable.
+	* Meant for maps that don't change after load, the table is saved with the level.
+	*/
+	UFUNCTION(CallInEditor, Category = "Grid|Path Database")
+	void BuildFirstMoveTable();
+
+	UFUNCTION(CallInEditor, Category = "Grid|Path Database")
+	void ClearFirstMoveTable();
+
+	bool IsFirstMoveTableValid() const;
+
+	/*
+	* Walks FirstMoveTable from start to goal, no search at all. MissingData if the table is out of date.
+	*/
+	UFUNCTION(BlueprintCallable)
+	TArray<int32> FirstMoveTablePath(int32 Start, int32 Goal);
+
+	EFGPathStatus FirstMoveTablePathInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength) const;
+
+	// Found when the table can be walked from Start to Goal, otherwise why not
+	EFGPathStatus CanWalkFirstMoveTable(int32 Start, int32 Goal) const;
+	// next tile on the way to Goal, -1 if the table has no move there
+	int32 GetFirstMoveTableStep(int32 Tile, int32 Goal) const;
+
+	UPROPERTY()
+	FFGFirstMoveTable FirstMoveTable;
+
+	/*
+	* What stepping onto the tile costs, 1 is plain ground and 0 gets treated as 1. Only the weighted searches
+	* below look at it, a cardinal step costs 10 times this and a diagonal one 14 times.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Grid|Terrain")
+	void SetTileCost(int32 TileIndex, uint8 Cost);
+
+	UFUNCTION(BlueprintPure, Category = "Grid|Terrain")
+	uint8 GetTileCost(int32 TileIndex) const;
+
+	/*
+	* Same box test UpdateBlockingTiles uses for block components, for painting mud or roads in one go.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Grid|Terrain")
+	void SetTileCostInArea(const FVector& Origin, const FVector& Extent, uint8 Cost);
+
+	/*
+	* A* over the cost plane, 8-connected without corner cutting. Returns every tile of the path.
+	*/
+	UFUNCTION(BlueprintCallable)
+	TArray<int32> WeightedAStar(int32 Start, int32 Goal);
+
+	/*
+	* Jump point search over the cost plane. Jumps only run through uniform patches (CostGrid.IsUniform),
+	* everywhere else it expands like WeightedAStar, so the result is just as cheap. Returns the jump points.
+	*/
+	UFUNCTION(BlueprintCallable)
+	TArray<int32> WeightedJPS(int32 Start, int32 Goal);
+
+	EFGPathStatus WeightedAStarInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength);
+	EFGPathStatus WeightedAStarInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+	                                FSearchScratch& Scratch) const;
+	EFGPathStatus WeightedJPSInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength);
+	EFGPathStatus WeightedJPSInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+	                              FSearchScratch& Scratch) const;
+
+	/*
+	* Dijkstra from Source over the whole cost plane, OutCosts gets the cheapest cost to every tile
+	* (MAX_int32 where it can't get). Same step costs as the weighted searches.
+	*/
+	void ComputeTravelCosts(int32 Source, TArray<int32>& OutCosts) const;
+
+	/*
+	* Every tile a unit on Origin can get to for at most Budget, with WeightedAStar's costs (a plain cardinal
+	* step is 10). Runs on the current snapshot and remembers the last ReachableCacheSize results by
+	* origin, budget and grid version, so asking again for the same unit is free until the grid changes.
+	* The reference stays valid until the next call.
+	*/
+	const FFGReachableTiles& GetReachableTiles(int32 Origin, int32 Budget);
+
+	/*
+	* Blueprint version, the reachable tiles and what getting to each costs.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Grid")
+	void GetMovementRange(int32 Origin, int32 Budget, TArray<int32>& OutTiles, TArray<int32>& OutCosts);
+
+	int32 ReachableCacheSize = 8;
+
+	/*
+	* Path preview from a unit on Start to the hovered Goal, cheap enough to ask every frame. Keeps one search tree
+	* rooted at Start and only grows it when Goal is further out than anything asked for before, so moving the
+	* mouse around mostly just walks parents. A different start or a grid change starts the tree over.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Grid")
+	TArray<int32> GetPreviewPath(int32 Start, int32 Goal);
+
+	EFGPathStatus GetPreviewPathInto(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength);
+
+	/*
+	* WeightedAStar that also pays for the influence on every tile it steps onto: Weight times the layer's value
+	* times the step cost. With a threat layer paths keep away from danger unless going around costs more.
+	*/
+	UFUNCTION(BlueprintCallable)
+	TArray<int32> InfluenceAStar(int32 Start, int32 Goal, FName Layer, float Weight = 1.0f);
+
+	EFGPathStatus InfluenceAStarInto(int32 Start, int32 Goal, FName Layer, float Weight, TArrayView<int32> OutPath,
+	                                 int32& OutPathLength, FSearchScratch& Scratch) const;
+
+	/*
+	* Influence layers over this grid (threat, ally presence, ...). Tick runs InfluencePassesPerSecond passes over
+	* each of them, spending at most InfluenceBudgetMs a frame.
+	*/
+	FFGInfluenceMap InfluenceMap;
+
+	/*
+	* Does nothing to a layer that already exists. Falloff, Momentum and Decay are per pass, see FFGInfluenceLayer.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Grid|Influence")
+	void AddInfluenceLayer(FName Layer, float Falloff = 0.8f, float Momentum = 0.5f, float Decay = 0.95f);
+
+	/*
+	* Once the last layer is gone the grid stops ticking for influence.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Grid|Influence")
+	void RemoveInfluenceLayer(FName Layer);
+
+	/*
+	* Adds Strength at the tile under WorldLocation, falling off to nothing at RadiusInTiles.
+	* Shows up once the layer's next pass is done.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Grid|Influence")
+	void StampInfluence(FName Layer, const FVector& WorldLocation, float RadiusInTiles, float Strength);
+
+	UFUNCTION(BlueprintPure, Category = "Grid|Influence")
+	float GetInfluence(FName Layer, int32 TileIndex) const;
+
+	/*
+	* Any-angle search, 8-connected without corner cutting. Only line of sight checks for the tiles
+	* that actually get expanded, so the result is a handful of waypoints instead of every tile.
+	*/
+	UFUNCTION(BlueprintCallable)
+	TArray<int32> LazyThetaStar(int32 Start, int32 Goal);
+
+	/*
+	* String pulling for a path from one of the other engines, drops every waypoint the previous kept one can see past.
+	*/
+	UFUNCTION(BlueprintCallable)
+	TArray<int32> SmoothPath(const TArray<int32>& Path) const;
+
+	UFUNCTION(BlueprintPure, Category = "Grid")
+	bool HasLineOfSight(int32 FromTile, int32 ToTile) const;
+
+	/*
+	* HasLineOfSight for many pairs at once, spread over the task graph. OutResults needs one element per pair.
+	* For batches that shouldn't hold up the game thread see UFGGridSubsystem::CheckLineOfSightAsync.
+	*/
+	void HasLineOfSightBatch(TArrayView<const FFGTilePair> Pairs, TArrayView<bool> OutResults) const;
+
+	/*
+	* Every tile Origin can see within Radius tiles (negative for no limit), sorted, blocked tiles facing it included.
+	* Visibility is symmetric, if A is in B's list then B is in A's.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Grid|Visibility")
+	TArray<int32> GetVisibleTiles(int32 Origin, int32 Radius) const;
+
+	void RebuildObstacleGrid();
+
+	void RebuildComponentLabels();
+
+	void RebuildClearance();
+
+	/*
+	* False means there is no path at all, whatever search gets asked. Blocked tiles aren't connected to anything.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Grid")
+	bool AreTilesConnected(int32 TileA, int32 TileB, EFGConnectivity Connectivity = EFGConnectivity::Four) const;
+
+	/*
+	* Everything the searches read: the bit-packed mirror of TileList[].bBlock, TileCosts, component labels
+	* and jump data. Rebuilt by UpdateBlockingTiles, the searches here just forward to it.
+	*/
+	FFGPathGrid PathGrid;
+
+	/*
+	* Immutable copy of PathGrid for readers off the game thread, held for as long as their query runs.
+	* Edits only mark the published copy stale, the next call on the game thread publishes a new version
+	* in one pointer swap. From any other thread this returns whatever was published last.
+	* Queries never block on edits and never see a half-built grid.
+	*/
+	FFGPathGridSnapshot AcquirePathGridSnapshot();
+
+	/*
+	* Actors standing on the grid, by tile. Tick moves every registered actor to the tile under it and re-buckets,
+	* Type is whatever the game wants to tell occupants apart by (unit, pickup, team, ...).
+	*/
+	FFGOccupancyGrid Occupancy;
+
+	/*
+	* Returns the occupant handle for RemoveOccupant. Destroyed actors drop out on their own.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Grid|Occupancy")
+	int32 AddOccupant(AActor* Actor, int32 Type);
+
+	UFUNCTION(BlueprintCallable, Category = "Grid|Occupancy")
+	void RemoveOccupant(int32 Handle);
+
+	/*
+	* Moves every occupant to the tile under it and re-buckets, Tick calls it. Only needed by hand after teleporting
+	* occupants when the queries have to see it before the next tick.
+	*/
+	void UpdateOccupants();
+
+	UFUNCTION(BlueprintCallable, Category = "Grid|Occupancy")
+	TArray<AActor*> GetActorsOnTile(int32 TileIndex) const;
+
+	/*
+	* Type -1 matches any type. Radius is in tiles, between tile centers.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Grid|Occupancy")
+	TArray<AActor*> GetActorsInRadius(int32 TileIndex, int32 Radius, int32 Type = -1) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Grid|Occupancy")
+	AActor* FindNearestActorOfType(int32 TileIndex, int32 Type, int32 MaxRadius = 32) const;
+
+	/*
+	* TileIndex itself if it's walkable, otherwise the closest tile that is within MaxRadius, INDEX_NONE if none.
+	* With bAllowOccupied false tiles somebody stands on don't count either.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Grid|Occupancy")
+	int32 FindNearestFreeTile(int32 TileIndex, int32 MaxRadius = 16, bool bAllowOccupied = true) const;
+
+	/*
+	* For code that edits PathGrid directly, the functions here already call it.
+	*/
+	void MarkPathGridDirty() { bPathGridDirty = true; }
+
+	/*
+	* Every UFGPathFollowingComponent on this grid, moved together from our Tick instead of one tick per agent.
+	*/
+	FFGPathFollowingManager PathFollowers;
+
 #if WITH_EDITOR
 	/*
 	* This is called whenever a property, on this Actor, is edited in the editor.
 	* Only available in the editor. If you forget WITH_EDITOR you will get a compile error when compiling the non-editor build
 	*/
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+
+	virtual void PostEditUndo() override;
 #endif //WITH_EDITOR
 
+private:
+	/*
+	* Everything the batch conversions need from the actor transform, rebuilt when the transform or grid size changes.
+	* Lazily refreshed from const functions, so game thread only.
+	*/
+	struct FTransformCache
+	{
+		FTransform SourceTransform;
+		int32 Width = 0;
+		int32 Height = 0;
+		float TileSize = 0.0f;
+		float BorderSize = 0.0f;
+		bool bValid = false;
+
+		FVector Origin;
+		// world axes of the rotation, dotting with them is the no-scale inverse transform
+		FVector InvAxisX;
+		FVector InvAxisY;
+		// rotated and scaled local axes for going back to world space
+		FVector AxisX;
+		FVector AxisY;
+	};
+
+	const FTransformCache& GetTransformCache() const;
+
+	/*
+	* Constant time early out for the searches, so a goal in a walled off area doesn't flood the whole grid first.
+	*/
+	bool IsGoalUnreachable(int32 Start, int32 Goal) const;
+
+	mutable FTransformCache TransformCache;
+
+	void PublishPathGrid();
+
+	TBitArray<> GetBlockedTiles() const;
+	TBitArray<> GetComponentBlockedTiles() const;
+
+	// what the block components covered at the last UpdateBlockingTiles, so painting knows what erasing may clear
+	TBitArray<> ComponentBlocks;
+	bool bTileEditsPending = false;
+	bool bRebuildJumpsAfterEdits = false;
+
+	/*
+	* Everything that follows TileList[].bBlock changing: block mesh, PathGrid, listeners and on the server the
+	* replicated deltas. PreviousBlocks is GetBlockedTiles from before the change.
+	*/
+	void CommitTileChanges(const TBitArray<>& PreviousBlocks);
+
+	// grid size the labels, clearance, influence and occupancy were last built for by CommitTileChanges or BeginPlay
+	FIntPoint CommittedSize = FIntPoint::ZeroValue;
+
+	// game worlds only, in the editor the grid is neither
+	bool IsReplicatedServer() const;
+	bool IsReplicatedClient() const;
+
+	// by occupant handle, plus UpdateOccupants' buffers so the tick doesn't allocate
+	TArray<TWeakObjectPtr<AActor>> OccupantActors;
+	TArray<int32> OccupantHandles;
+	TArray<FVector> OccupantLocations;
+	TArray<int32> OccupantTiles;
+
+	// most recently used last, evicted entries get their memory reused
+	TArray<FFGReachableTiles> ReachableCache;
+	FFGRangeScratch RangeScratch;
+
+	FFGPathPreview PathPreview;
+
+	// guards PublishedPathGrid, the only part of the grid other threads touch
+	FCriticalSection SnapshotLock;
+	TSharedPtr<FFGPathGrid, ESPMode::ThreadSafe> PublishedPathGrid;
+	// the version before PublishedPathGrid, its memory gets reused once the last reader lets go of it
+	TSharedPtr<FFGPathGrid, ESPMode::ThreadSafe> RetiredPathGrid;
+	bool bPathGridDirty = true;
+
+	/*
+	* Blueprint wrappers end up here, rebuilds the path of the last search out of SearchScratch into a new array.
+	*/
+	TArray<int32> CopyScratchPath(int32 Goal, int32 PathLength);
+
+public:
+
 	UFUNCTION(BlueprintPure, Category = "Grid")
 	float GetTileSizeHalf() const { return TileSize * 0.5f; }
 	UFUNCTION(BlueprintPure, Category = "Grid")
@@ -202,6 +716,27 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "Grid")
 	TArray<FFGTileinfo> TileList;
 
+	/*
+	* One traversal cost per tile, see SetTileCost. Its own plane so TileList doesn't grow for it.
+	*/
+	UPROPERTY()
+	TArray<uint8> TileCosts;
+
+	// the grid size TileCosts was laid out for, a resize with the same tile count still starts them over
+	UPROPERTY()
+	FIntPoint TileCostsSize = FIntPoint::ZeroValue;
+
+	void FitTileCosts();
+
+	/*
+	* ImportObstacles' tiles, one bit each, for the grid size they were imported at.
+	*/
+	UPROPERTY()
+	TArray<uint32> ImportedBlocks;
+
+	UPROPERTY()
+	FIntPoint ImportedSize = FIntPoint::ZeroValue;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Grid, meta = (ClampMin = 1))
 	int Width = 10;
 
@@ -213,4 +748,24 @@ public:
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Grid)
 	float TileSize = 500.0f;
+
+	/*
+	* Adds goal bounds to the jump data (FFGPathGrid::BuildGoalBounds), JPS queries skip every direction the goal
+	* can't be reached through. Costs a full search per tile whenever the obstacles change, keep it to static maps.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Grid)
+	bool bGoalBounding = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Influence", meta = (ClampMin = 0))
+	float InfluenceBudgetMs = 0.5f;
+
+	// propagation passes per layer and second, InfluenceBudgetMs only caps how much of that one frame may do
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Influence", meta = (ClampMin = 0))
+	float InfluencePassesPerSecond = 10.0f;
+
+	/*
+	* Draws the path and the searched tiles of every Blueprint path query for a few seconds. Compiled out of shipping builds.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Debug")
+	bool bDrawDebugPaths = false;
 };
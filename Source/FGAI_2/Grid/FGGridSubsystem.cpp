@@ -0,0 +1,313 @@
+#include "FGGridSubsystem.h"
+
+#include "Async/Async.h"
+#include "Misc/QueuedThreadPool.h"
+
+namespace
+{
+	class FFGPathQueryWork : public IQueuedWork
+	{
+	public:
+		FFGPathQueryWork(UFGGridSubsystem* InSubsystem, AFGGridActor* InGridActor, int32 InStart, int32 InGoal,
+		                 FFGOnAsyncPathFound InOnComplete)
+			: Subsystem(InSubsystem)
+			, GridActor(InGridActor)
+			, Grid(InGridActor->AcquirePathGridSnapshot())
+			, Start(InStart)
+			, Goal(InGoal)
+			, OnComplete(MoveTemp(InOnComplete))
+		{
+			Scratch = Subsystem->AcquireScratch();
+		}
+
+		virtual void DoThreadedWork() override
+		{
+			TArray<int32> Path;
+			int32 PathLength = 0;
+			EFGPathStatus Status = Grid->JPSRuntime(Start, Goal, TArrayView<int32>(), PathLength, *Scratch);
+			if (Status == EFGPathStatus::Truncated)
+			{
+				Path.SetNumUninitialized(PathLength);
+				Status = Grid->ConstructPath(Scratch->Parent, Goal, Path, PathLength);
+			}
+
+			// Deinitialize waits for running work before it goes away, so the subsystem is still here
+			Subsystem->ReleaseScratch(MoveTemp(Scratch));
+
+			FFGOnAsyncPathFound Callback = MoveTemp(OnComplete);
+			AsyncTask(ENamedThreads::GameThread, [Callback, GridActor = GridActor, Status, Path = MoveTemp(Path)]()
+			{
+				// the tiles belong to a grid that is gone by now
+				if (!GridActor.IsValid())
+				{
+					Callback.ExecuteIfBound(EFGPathStatus::InvalidTiles, TArray<int32>());
+					return;
+				}
+				Callback.ExecuteIfBound(Status, Path);
+			});
+
+			delete this;
+		}
+
+		// the pool is going away with us still queued, the caller still gets an answer
+		virtual void Abandon() override
+		{
+			Subsystem->ReleaseScratch(MoveTemp(Scratch));
+
+			FFGOnAsyncPathFound Callback = MoveTemp(OnComplete);
+			AsyncTask(ENamedThreads::GameThread, [Callback]()
+			{
+				Callback.ExecuteIfBound(EFGPathStatus::Aborted, TArray<int32>());
+			});
+
+			delete this;
+		}
+
+	private:
+		UFGGridSubsystem* Subsystem;
+		// only checked back on the game thread, the search itself never touches the actor
+		TWeakObjectPtr<AFGGridActor> GridActor;
+		// the grid as it was when the query was made, edits since then don't reach us
+		FFGPathGridSnapshot Grid;
+		int32 Start;
+		int32 Goal;
+		FFGOnAsyncPathFound OnComplete;
+		TUniquePtr<AFGGridActor::FSearchScratch> Scratch;
+	};
+
+	class FFGLineOfSightWork : public IQueuedWork
+	{
+	public:
+		FFGLineOfSightWork(FFGPathGridSnapshot InGrid, TArray<FFGTilePair> InPairs, FFGOnAsyncLineOfSightChecked InOnComplete)
+			: Grid(MoveTemp(InGrid))
+			, Pairs(MoveTemp(InPairs))
+			, OnComplete(MoveTemp(InOnComplete))
+		{
+		}
+
+		virtual void DoThreadedWork() override
+		{
+			TArray<bool> Results;
+			Results.SetNumUninitialized(Pairs.Num());
+			FFGVisibility::HasLineOfSightBatch(Grid->ObstacleGrid, Pairs, Results);
+
+			FFGOnAsyncLineOfSightChecked Callback = MoveTemp(OnComplete);
+			AsyncTask(ENamedThreads::GameThread, [Callback, Results = MoveTemp(Results)]()
+			{
+				Callback.ExecuteIfBound(Results);
+			});
+
+			delete this;
+		}
+
+		// never ran, every pair comes back as not visible so the caller isn't left waiting
+		virtual void Abandon() override
+		{
+			TArray<bool> Results;
+			Results.SetNumZeroed(Pairs.Num());
+
+			FFGOnAsyncLineOfSightChecked Callback = MoveTemp(OnComplete);
+			AsyncTask(ENamedThreads::GameThread, [Callback, Results = MoveTemp(Results)]()
+			{
+				Callback.ExecuteIfBound(Results);
+			});
+
+			delete this;
+		}
+
+	private:
+		FFGPathGridSnapshot Grid;
+		TArray<FFGTilePair> Pairs;
+		FFGOnAsyncLineOfSightChecked OnComplete;
+	};
+}
+
+void UFGGridSubsystem::Deinitialize()
+{
+	if (ThreadPool != nullptr)
+	{
+		ThreadPool->Destroy();
+		delete ThreadPool;
+		ThreadPool = nullptr;
+	}
+
+	Grids.Reset();
+	CellToGrids.Reset();
+	ScratchPool.Reset();
+
+	Super::Deinitialize();
+}
+
+void UFGGridSubsystem::RegisterGrid(AFGGridActor* Grid)
+{
+	if (Grid == nullptr || Grids.Contains(Grid))
+		return;
+
+	Grids.Add(Grid);
+	AddToIndex(Grid);
+}
+
+void UFGGridSubsystem::UnregisterGrid(AFGGridActor* Grid)
+{
+	if (Grids.Remove(Grid) > 0)
+	{
+		RemoveFromIndex(Grid);
+	}
+}
+
+void UFGGridSubsystem::UpdateGrid(AFGGridActor* Grid)
+{
+	if (!Grids.Contains(Grid))
+		return;
+
+	RemoveFromIndex(Grid);
+	AddToIndex(Grid);
+}
+
+AFGGridActor* UFGGridSubsystem::GetGridAtLocation(const FVector& WorldLocation) const
+{
+	const auto* CellGrids = CellToGrids.Find(GetCell(FVector2D(WorldLocation)));
+	if (CellGrids == nullptr)
+		return nullptr;
+
+	for (AFGGridActor* Grid : *CellGrids)
+	{
+		if (Grid->IsWorldLocationInsideGrid(WorldLocation))
+			return Grid;
+	}
+	return nullptr;
+}
+
+AFGGridActor* UFGGridSubsystem::GetDefaultGrid() const
+{
+	return Grids.Num() > 0 ? Grids[0] : nullptr;
+}
+
+TUniquePtr<AFGGridActor::FSearchScratch> UFGGridSubsystem::AcquireScratch()
+{
+	FScopeLock Lock(&ScratchLock);
+	if (ScratchPool.Num() > 0)
+		return ScratchPool.Pop(false);
+
+	return MakeUnique<AFGGridActor::FSearchScratch>();
+}
+
+void UFGGridSubsystem::ReleaseScratch(TUniquePtr<AFGGridActor::FSearchScratch> Scratch)
+{
+	if (!Scratch.IsValid())
+		return;
+
+	FScopeLock Lock(&ScratchLock);
+	ScratchPool.Add(MoveTemp(Scratch));
+}
+
+FQueuedThreadPool* UFGGridSubsystem::GetThreadPool()
+{
+	if (ThreadPool == nullptr && FPlatformProcess::SupportsMultithreading())
+	{
+		ThreadPool = FQueuedThreadPool::Allocate();
+		verify(ThreadPool->Create(FMath::Max(NumWorkerThreads, 1), 128 * 1024, TPri_BelowNormal, TEXT("FGGridPathfinding")));
+	}
+	return ThreadPool;
+}
+
+void UFGGridSubsystem::FindPathAsync(AFGGridActor* Grid, int32 Start, int32 Goal, FFGOnAsyncPathFound OnComplete)
+{
+	if (!IsValid(Grid))
+	{
+		OnComplete.ExecuteIfBound(EFGPathStatus::InvalidTiles, TArray<int32>());
+		return;
+	}
+
+	FQueuedThreadPool* Pool = GetThreadPool();
+	if (Pool == nullptr)
+	{
+		// No threads on this platform, answer right away
+		TArray<int32> Path;
+		int32 PathLength = 0;
+		EFGPathStatus Status = Grid->JPSRuntimeInto(Start, Goal, TArrayView<int32>(), PathLength);
+		if (Status == EFGPathStatus::Truncated)
+		{
+			Path.SetNumUninitialized(PathLength);
+			Status = Grid->ConstructPathInto(Grid->SearchScratch.Parent, Goal, Path, PathLength);
+		}
+		OnComplete.ExecuteIfBound(Status, Path);
+		return;
+	}
+
+	// the snapshot gets published from PathGrid, so it has to be current before the work grabs it
+	if (!Grid->PathGrid.HasJumpData() || Grid->PathGrid.Width != Grid->Width || Grid->PathGrid.Height != Grid->Height)
+		Grid->JPSPreProcess();
+
+	Pool->AddQueuedWork(new FFGPathQueryWork(this, Grid, Start, Goal, MoveTemp(OnComplete)));
+}
+
+void UFGGridSubsystem::CheckLineOfSightAsync(AFGGridActor* Grid, TArray<FFGTilePair> Pairs, FFGOnAsyncLineOfSightChecked OnComplete)
+{
+	TArray<bool> Results;
+	if (!IsValid(Grid))
+	{
+		Results.SetNumZeroed(Pairs.Num());
+		OnComplete.ExecuteIfBound(Results);
+		return;
+	}
+
+	FQueuedThreadPool* Pool = GetThreadPool();
+	if (Pool == nullptr)
+	{
+		Results.SetNumUninitialized(Pairs.Num());
+		Grid->HasLineOfSightBatch(Pairs, Results);
+		OnComplete.ExecuteIfBound(Results);
+		return;
+	}
+
+	Pool->AddQueuedWork(new FFGLineOfSightWork(Grid->AcquirePathGridSnapshot(), MoveTemp(Pairs), MoveTemp(OnComplete)));
+}
+
+FBox2D UFGGridSubsystem::GetGridBounds(const AFGGridActor* Grid) const
+{
+	const FTransform& GridTransform = Grid->GetActorTransform();
+	const float HalfX = Grid->GetWidthSize();
+	const float HalfY = Grid->GetHeightSize();
+
+	FBox2D Bounds(ForceInit);
+	const FVector Corners[4] = {
+		FVector(-HalfX, -HalfY, 0.0f), FVector(HalfX, -HalfY, 0.0f),
+		FVector(-HalfX, HalfY, 0.0f), FVector(HalfX, HalfY, 0.0f)
+	};
+	for (const FVector& Corner : Corners)
+	{
+		Bounds += FVector2D(GridTransform.TransformPositionNoScale(Corner));
+	}
+	return Bounds;
+}
+
+FIntPoint UFGGridSubsystem::GetCell(const FVector2D& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / IndexCellSize), FMath::FloorToInt(Location.Y / IndexCellSize));
+}
+
+void UFGGridSubsystem::AddToIndex(AFGGridActor* Grid)
+{
+	const FBox2D Bounds = GetGridBounds(Grid);
+	const FIntPoint MinCell = GetCell(Bounds.Min);
+	const FIntPoint MaxCell = GetCell(Bounds.Max);
+
+	for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+	{
+		for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+		{
+			CellToGrids.FindOrAdd(FIntPoint(CellX, CellY)).Add(Grid);
+		}
+	}
+}
+
+void UFGGridSubsystem::RemoveFromIndex(AFGGridActor* Grid)
+{
+	for (auto It = CellToGrids.CreateIterator(); It; ++It)
+	{
+		It.Value().Remove(Grid);
+		if (It.Value().Num() == 0)
+			It.RemoveCurrent();
+	}
+}
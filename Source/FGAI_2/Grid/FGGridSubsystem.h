@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "FGGridActor.h"
+#include "FGGridSubsystem.generated.h"
+
+class FQueuedThreadPool;
+
+DECLARE_DELEGATE_TwoParams(FFGOnAsyncPathFound, EFGPathStatus /*Status*/, const TArray<int32>& /*Path*/);
+DECLARE_DELEGATE_OneParam(FFGOnAsyncLineOfSightChecked, const TArray<bool>& /*Results*/);
+
+/*
+* Knows every AFGGridActor in the world and which one covers a world location, so nobody has to
+* GetAllActorsOfClass for grids anymore. Also owns what the grids share: the pathfinding worker threads
+* and a pool of search scratch buffers for queries that don't run on the game thread.
+*/
+UCLASS()
+class FGAI_2_API UFGGridSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	virtual void Deinitialize() override;
+
+	void RegisterGrid(AFGGridActor* Grid);
+	void UnregisterGrid(AFGGridActor* Grid);
+
+	/*
+	* Call after a registered grid was moved or resized so the spatial index follows.
+	*/
+	void UpdateGrid(AFGGridActor* Grid);
+
+	UFUNCTION(BlueprintPure, Category = "Grid")
+	AFGGridActor* GetGridAtLocation(const FVector& WorldLocation) const;
+
+	/*
+	* First registered grid, for the many places that only ever deal with one.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Grid")
+	AFGGridActor* GetDefaultGrid() const;
+
+	const TArray<AFGGridActor*>& GetGrids() const { return Grids; }
+
+	/*
+	* Scratch buffers for searching FFGPathGrid snapshots off the game thread. Thread safe.
+	*/
+	TUniquePtr<AFGGridActor::FSearchScratch> AcquireScratch();
+	void ReleaseScratch(TUniquePtr<AFGGridActor::FSearchScratch> Scratch);
+
+	/*
+	* Lazily created the first time something wants to run pathfinding work in the background.
+	*/
+	FQueuedThreadPool* GetThreadPool();
+
+	/*
+	* Runs JPSRuntime on the worker threads, OnComplete gets called on the game thread.
+	* The query searches the grid's snapshot from when it was made, the grid is free to change meanwhile.
+	* If the grid actor is destroyed before the result is back, OnComplete gets InvalidTiles,
+	* and Aborted if the subsystem shuts down before the query got to run.
+	*/
+	void FindPathAsync(AFGGridActor* Grid, int32 Start, int32 Goal, FFGOnAsyncPathFound OnComplete);
+
+	/*
+	* Line of sight for every pair on a worker thread, against the grid's snapshot from when it was asked.
+	* OnComplete gets one result per pair, on the game thread. All false if the subsystem shuts down before the check ran.
+	*/
+	void CheckLineOfSightAsync(AFGGridActor* Grid, TArray<FFGTilePair> Pairs, FFGOnAsyncLineOfSightChecked OnComplete);
+
+	float IndexCellSize = 10000.0f;
+	int32 NumWorkerThreads = 2;
+
+private:
+	FBox2D GetGridBounds(const AFGGridActor* Grid) const;
+	FIntPoint GetCell(const FVector2D& Location) const;
+	void AddToIndex(AFGGridActor* Grid);
+	void RemoveFromIndex(AFGGridActor* Grid);
+
+	UPROPERTY()
+	TArray<AFGGridActor*> Grids;
+
+	/*
+	* Uniform hash over world XY, each cell lists the grids overlapping it.
+	*/
+	TMap<FIntPoint, TArray<AFGGridActor*, TInlineAllocator<2>>> CellToGrids;
+
+	FCriticalSection ScratchLock;
+	TArray<TUniquePtr<AFGGridActor::FSearchScratch>> ScratchPool;
+
+	FQueuedThreadPool* ThreadPool = nullptr;
+};
@@ -0,0 +1,146 @@
+#include "FGObstacleReplication.h"
+
+#include "FGGridActor.h"
+
+DEFINE_LOG_CATEGORY(LogFGObstacleReplication);
+
+void FFGTileRuns::Build(const TArray<int32>& Tiles)
+{
+	Starts.Reset();
+	Lengths.Reset();
+	for (const int32 Tile : Tiles)
+	{
+		if (Starts.Num() > 0 && Starts.Last() + Lengths.Last() == Tile)
+		{
+			++Lengths.Last();
+			continue;
+		}
+		Starts.Add(Tile);
+		Lengths.Add(1);
+	}
+}
+
+bool FFGTileRuns::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// anything bigger didn't come from us, a whole map of alternating tiles stays well below it
+	constexpr uint32 MaxRuns = 1 << 22;
+
+	uint32 NumRuns = Starts.Num();
+	Ar.SerializeIntPacked(NumRuns);
+	if (Ar.IsLoading())
+	{
+		if (NumRuns > MaxRuns)
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+		Starts.SetNumUninitialized(NumRuns);
+		Lengths.SetNumUninitialized(NumRuns);
+	}
+
+	uint32 PreviousEnd = 0;
+	for (uint32 Run = 0; Run < NumRuns && !Ar.IsError(); ++Run)
+	{
+		uint32 Gap = Ar.IsSaving() ? Starts[Run] - PreviousEnd : 0;
+		uint32 Length = Ar.IsSaving() ? Lengths[Run] : 0;
+		Ar.SerializeIntPacked(Gap);
+		Ar.SerializeIntPacked(Length);
+
+		if (Ar.IsLoading())
+		{
+			// a run ending past any tile index we could have would overflow Starts + Lengths
+			if (static_cast<uint64>(PreviousEnd) + Gap + Length > MAX_int32)
+			{
+				Ar.SetError();
+				bOutSuccess = false;
+				return false;
+			}
+			Starts[Run] = PreviousEnd + Gap;
+			Lengths[Run] = Length;
+		}
+		PreviousEnd = Starts[Run] + Lengths[Run];
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+int32 FFGTileRuns::GetEnd() const
+{
+	return Num() > 0 ? Starts.Last() + Lengths.Last() : 0;
+}
+
+void FFGObstacleDelta::PostReplicatedAdd(const FFGObstacleDeltaArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner != nullptr)
+		InArraySerializer.Owner->ApplyReplicatedObstacles();
+}
+
+void FFGObstacleDelta::PostReplicatedChange(const FFGObstacleDeltaArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner != nullptr)
+		InArraySerializer.Owner->ApplyReplicatedObstacles();
+}
+
+void FFGObstacleDeltaArray::RecordBase(const AFGGridActor& Grid)
+{
+	TArray<int32> BlockedTiles;
+	for (int32 TileIndex = 0, Num = Grid.TileList.Num(); TileIndex < Num; ++TileIndex)
+	{
+		if (Grid.TileList[TileIndex].bBlock)
+			BlockedTiles.Add(TileIndex);
+	}
+
+	Items.Reset();
+	FFGObstacleDelta& Base = Items.AddDefaulted_GetRef();
+	Base.Version = ++LatestVersion;
+	Base.bBase = true;
+	Base.Width = Grid.Width;
+	Base.Height = Grid.Height;
+	Base.Blocked.Build(BlockedTiles);
+
+	MarkItemDirty(Base);
+	MarkArrayDirty();
+}
+
+void FFGObstacleDeltaArray::RecordChanges(const AFGGridActor& Grid, const TArray<int32>& ChangedTiles)
+{
+	if (ChangedTiles.Num() == 0)
+		return;
+
+	if (Items.Num() == 0 || Items.Num() > MaxDeltas)
+	{
+		RecordBase(Grid);
+		return;
+	}
+
+	TArray<int32> BlockedTiles;
+	TArray<int32> ClearedTiles;
+	for (const int32 Tile : ChangedTiles)
+	{
+		if (Grid.TileList[Tile].bBlock)
+			BlockedTiles.Add(Tile);
+		else
+			ClearedTiles.Add(Tile);
+	}
+
+	FFGObstacleDelta Delta;
+	Delta.Blocked.Build(BlockedTiles);
+	Delta.Cleared.Build(ClearedTiles);
+
+	// a base is at least as small as all the deltas since the last one, time to start over
+	int32 HistoryRuns = Delta.Blocked.Num() + Delta.Cleared.Num();
+	for (int32 Index = 1; Index < Items.Num(); ++Index)
+	{
+		HistoryRuns += Items[Index].Blocked.Num() + Items[Index].Cleared.Num();
+	}
+	if (HistoryRuns > FMath::Max(Items[0].Blocked.Num(), 64))
+	{
+		RecordBase(Grid);
+		return;
+	}
+
+	Delta.Version = ++LatestVersion;
+	MarkItemDirty(Items.Add_GetRef(MoveTemp(Delta)));
+}
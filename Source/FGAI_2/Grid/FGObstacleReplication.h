@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "FGObstacleReplication.generated.h"
+
+class AFGGridActor;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogFGObstacleReplication, Log, All);
+
+/*
+* Sorted, non-overlapping tile ranges. On the wire every range is the gap since the end of the previous one
+* plus its length, both packed, so a block of a few tiles costs a couple of bytes wherever it is on the map.
+*/
+USTRUCT()
+struct FFGTileRuns
+{
+	GENERATED_BODY()
+public:
+	TArray<int32> Starts;
+	TArray<int32> Lengths;
+
+	int32 Num() const { return Starts.Num(); }
+
+	// one past the last tile, the runs are sorted so that's the end of the last one
+	int32 GetEnd() const;
+
+	// Tiles has to be sorted
+	void Build(const TArray<int32>& Tiles);
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template <>
+struct TStructOpsTypeTraits<FFGTileRuns> : public TStructOpsTypeTraitsBase2<FFGTileRuns>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/*
+* One published change of the obstacles. A base is the whole map (blocked runs over an all clear grid),
+* everything else sets the tiles in Blocked and clears the ones in Cleared on top of Version - 1.
+*/
+USTRUCT()
+struct FFGObstacleDelta : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY()
+	uint32 Version = 0;
+
+	UPROPERTY()
+	bool bBase = false;
+
+	// grid size, only bases carry it
+	UPROPERTY()
+	int32 Width = 0;
+
+	UPROPERTY()
+	int32 Height = 0;
+
+	UPROPERTY()
+	FFGTileRuns Blocked;
+
+	UPROPERTY()
+	FFGTileRuns Cleared;
+
+	void PostReplicatedAdd(const struct FFGObstacleDeltaArray& InArraySerializer);
+	void PostReplicatedChange(const struct FFGObstacleDeltaArray& InArraySerializer);
+};
+
+/*
+* The server's obstacle history since the last base. Late joiners get the base and the deltas after it,
+* everybody else only the deltas they haven't seen. Once the deltas add up to more than a fresh base
+* would cost they get folded into one, so the history never grows past the size of the map.
+*/
+USTRUCT()
+struct FFGObstacleDeltaArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY()
+	TArray<FFGObstacleDelta> Items;
+
+	// not replicated, set by the owning grid
+	AFGGridActor* Owner = nullptr;
+
+	// server: version of the newest item, client: newest version applied to the grid
+	uint32 LatestVersion = 0;
+
+	// deltas folded into a base once there are more of them than this
+	int32 MaxDeltas = 32;
+
+	/*
+	* Server side. RecordBase starts the history over from the grid as it is, RecordChanges adds the
+	* tiles that flipped since the last record (sorted).
+	*/
+	void RecordBase(const AFGGridActor& Grid);
+	void RecordChanges(const AFGGridActor& Grid, const TArray<int32>& ChangedTiles);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FFGObstacleDelta, FFGObstacleDeltaArray>(Items, DeltaParms, *this);
+	}
+};
+
+template <>
+struct TStructOpsTypeTraits<FFGObstacleDeltaArray> : public TStructOpsTypeTraitsBase2<FFGObstacleDeltaArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -0,0 +1,82 @@
+#include "FGPathFollowingComponent.h"
+
+#include "FGAI_2/Grid/FGGridActor.h"
+#include "FGAI_2/Grid/FGGridSubsystem.h"
+
+UFGPathFollowingComponent::UFGPathFollowingComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UFGPathFollowingComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (Grid == nullptr)
+	{
+		if (UFGGridSubsystem* GridSubsystem = UWorld::GetSubsystem<UFGGridSubsystem>(GetWorld()))
+		{
+			Grid = GridSubsystem->GetGridAtLocation(GetOwner()->GetActorLocation());
+			if (Grid == nullptr)
+				Grid = GridSubsystem->GetDefaultGrid();
+		}
+	}
+
+	if (Grid != nullptr)
+		AgentIndex = Grid->PathFollowers.AddAgent(this, GetOwner()->GetActorLocation(), Speed);
+}
+
+void UFGPathFollowingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (Grid != nullptr && AgentIndex != INDEX_NONE)
+		Grid->PathFollowers.RemoveAgent(AgentIndex);
+	AgentIndex = INDEX_NONE;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UFGPathFollowingComponent::FollowPath(const TArray<int32>& TilePath)
+{
+	if (Grid == nullptr || AgentIndex == INDEX_NONE)
+		return false;
+
+	TArray<FVector> Waypoints;
+	Waypoints.SetNumUninitialized(TilePath.Num());
+	Grid->GetWorldLocationsFromTileIndices(TilePath, Waypoints);
+
+	// stay at our own height over the grid, the tile centers are on its plane
+	const float HeightOffset = GetOwner()->GetActorLocation().Z - Grid->GetActorLocation().Z;
+	for (FVector& Waypoint : Waypoints)
+	{
+		Waypoint.Z += HeightOffset;
+	}
+
+	Grid->PathFollowers.SetLocation(AgentIndex, GetOwner()->GetActorLocation());
+	Grid->PathFollowers.SetPath(AgentIndex, MoveTemp(Waypoints));
+	Grid->SetActorTickEnabled(true);
+	return true;
+}
+
+void UFGPathFollowingComponent::StopFollowing()
+{
+	if (Grid != nullptr && AgentIndex != INDEX_NONE)
+		Grid->PathFollowers.SetPath(AgentIndex, TArray<FVector>());
+}
+
+bool UFGPathFollowingComponent::IsFollowingPath() const
+{
+	return Grid != nullptr && AgentIndex != INDEX_NONE && Grid->PathFollowers.IsFollowingPath(AgentIndex);
+}
+
+void UFGPathFollowingComponent::SetSpeed(float NewSpeed)
+{
+	Speed = FMath::Max(NewSpeed, 0.0f);
+	if (Grid != nullptr && AgentIndex != INDEX_NONE)
+		Grid->PathFollowers.SetSpeed(AgentIndex, Speed);
+}
+
+void UFGPathFollowingComponent::SyncLocation()
+{
+	if (Grid != nullptr && AgentIndex != INDEX_NONE)
+		Grid->PathFollowers.SetLocation(AgentIndex, GetOwner()->GetActorLocation());
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "FGPathFollowingComponent.generated.h"
+
+class AFGGridActor;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FFGOnPathFinished);
+
+/*
+* Walks its actor along tile paths from the grid searches. It doesn't tick itself: the agent lives in the
+* grid's FFGPathFollowingManager from BeginPlay to EndPlay and the grid moves all of its agents in one tick.
+*/
+UCLASS(BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
+class FGAI_2_API UFGPathFollowingComponent : public UActorComponent
+{
+	GENERATED_BODY()
+public:
+	UFGPathFollowingComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/*
+	* Walks through the centers of the tiles in order, e.g. the result of JPSRuntime. Returns false without a grid.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Path Following")
+	bool FollowPath(const TArray<int32>& TilePath);
+
+	UFUNCTION(BlueprintCallable, Category = "Path Following")
+	void StopFollowing();
+
+	UFUNCTION(BlueprintPure, Category = "Path Following")
+	bool IsFollowingPath() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Path Following")
+	void SetSpeed(float NewSpeed);
+
+	/*
+	* For when the actor gets moved by something else, the agent carries on from the new location.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Path Following")
+	void SyncLocation();
+
+	// units per second
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Path Following", meta = (ClampMin = 0))
+	float Speed = 600.0f;
+
+	/*
+	* The grid the paths are on, the one under the actor at BeginPlay unless set before that.
+	*/
+	UPROPERTY(BlueprintReadOnly, Category = "Path Following")
+	AFGGridActor* Grid = nullptr;
+
+	// broadcast from the grid's tick once the last waypoint is reached
+	UPROPERTY(BlueprintAssignable, Category = "Path Following")
+	FFGOnPathFinished OnPathFinished;
+
+	// slot in Grid->PathFollowers, kept up to date by the manager
+	int32 AgentIndex = INDEX_NONE;
+};
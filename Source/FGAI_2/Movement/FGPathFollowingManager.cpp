@@ -0,0 +1,130 @@
+#include "FGPathFollowingManager.h"
+
+#include "FGPathFollowingComponent.h"
+#include "Async/ParallelFor.h"
+#include "GameFramework/Actor.h"
+
+int32 FFGPathFollowingManager::AddAgent(UFGPathFollowingComponent* Component, const FVector& Location, float Speed)
+{
+	Components.Add(Component);
+	Locations.Add(Location);
+	Speeds.Add(Speed);
+	Cursors.Add(INDEX_NONE);
+	Paths.AddDefaulted();
+	Moved.Add(0);
+	Arrived.Add(0);
+	return Components.Num() - 1;
+}
+
+void FFGPathFollowingManager::RemoveAgent(int32 AgentIndex)
+{
+	if (!Components.IsValidIndex(AgentIndex))
+		return;
+
+	if (Cursors[AgentIndex] != INDEX_NONE)
+		--NumFollowing;
+
+	Components.RemoveAtSwap(AgentIndex, 1, false);
+	Locations.RemoveAtSwap(AgentIndex, 1, false);
+	Speeds.RemoveAtSwap(AgentIndex, 1, false);
+	Cursors.RemoveAtSwap(AgentIndex, 1, false);
+	Paths.RemoveAtSwap(AgentIndex, 1, false);
+	Moved.RemoveAtSwap(AgentIndex, 1, false);
+	Arrived.RemoveAtSwap(AgentIndex, 1, false);
+
+	if (Components.IsValidIndex(AgentIndex))
+		Components[AgentIndex]->AgentIndex = AgentIndex;
+}
+
+void FFGPathFollowingManager::SetPath(int32 AgentIndex, TArray<FVector>&& Waypoints)
+{
+	const bool bWasFollowing = Cursors[AgentIndex] != INDEX_NONE;
+	Paths[AgentIndex] = MoveTemp(Waypoints);
+	Cursors[AgentIndex] = Paths[AgentIndex].Num() > 0 ? 0 : INDEX_NONE;
+	NumFollowing += (Cursors[AgentIndex] != INDEX_NONE) - bWasFollowing;
+}
+
+void FFGPathFollowingManager::SetSpeed(int32 AgentIndex, float Speed)
+{
+	Speeds[AgentIndex] = Speed;
+}
+
+void FFGPathFollowingManager::SetLocation(int32 AgentIndex, const FVector& Location)
+{
+	Locations[AgentIndex] = Location;
+}
+
+void FFGPathFollowingManager::Tick(float DeltaSeconds)
+{
+	const int32 NumAgents = Components.Num();
+	if (NumFollowing == 0)
+		return;
+
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumAgents, FMath::Max(1, AgentsPerBatch));
+	ParallelFor(NumBatches, [this, NumAgents, DeltaSeconds](int32 Batch)
+	{
+		const int32 First = Batch * AgentsPerBatch;
+		const int32 Last = FMath::Min(First + AgentsPerBatch, NumAgents);
+		for (int32 Agent = First; Agent < Last; ++Agent)
+		{
+			Moved[Agent] = 0;
+			Arrived[Agent] = 0;
+
+			int32 Cursor = Cursors[Agent];
+			if (Cursor == INDEX_NONE)
+				continue;
+
+			const TArray<FVector>& Path = Paths[Agent];
+			FVector Location = Locations[Agent];
+			float Remaining = Speeds[Agent] * DeltaSeconds;
+
+			// a fast agent can pass several waypoints in one frame
+			while (Remaining > 0.0f && Cursor < Path.Num())
+			{
+				const FVector ToWaypoint = Path[Cursor] - Location;
+				const float Distance = ToWaypoint.Size();
+				if (Distance <= Remaining)
+				{
+					Location = Path[Cursor];
+					Remaining -= Distance;
+					++Cursor;
+				}
+				else
+				{
+					Location += ToWaypoint * (Remaining / Distance);
+					Remaining = 0.0f;
+				}
+			}
+
+			if (Cursor == Path.Num())
+			{
+				Cursor = INDEX_NONE;
+				Arrived[Agent] = 1;
+			}
+
+			Moved[Agent] = Location != Locations[Agent];
+			Locations[Agent] = Location;
+			Cursors[Agent] = Cursor;
+		}
+	}, NumBatches == 1);
+
+	TArray<UFGPathFollowingComponent*, TInlineAllocator<16>> ArrivedComponents;
+	for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+	{
+		if (Moved[Agent])
+		{
+			if (AActor* Owner = Components[Agent]->GetOwner())
+				Owner->SetActorLocation(Locations[Agent]);
+		}
+		if (Arrived[Agent])
+			ArrivedComponents.Add(Components[Agent]);
+	}
+
+	NumFollowing -= ArrivedComponents.Num();
+
+	// last, listeners may well hand out new paths or remove agents
+	for (UFGPathFollowingComponent* Component : ArrivedComponents)
+	{
+		Component->OnPathFinished.Broadcast();
+	}
+}
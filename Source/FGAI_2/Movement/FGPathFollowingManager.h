@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UFGPathFollowingComponent;
+
+/*
+* Every path follower on a grid in one place, one array per field. AFGGridActor owns one and ticks it once
+* for all of its agents: the movement runs over the arrays on task graph workers, then the new locations
+* get written to the actors in one pass on the game thread. Agents are kept packed, removing one moves the
+* last agent into its slot and tells that agent's component about it.
+*/
+class FGAI_2_API FFGPathFollowingManager
+{
+public:
+	/*
+	* Returns the agent index, the component has to hand it back to every call below.
+	*/
+	int32 AddAgent(UFGPathFollowingComponent* Component, const FVector& Location, float Speed);
+	void RemoveAgent(int32 AgentIndex);
+
+	/*
+	* Waypoints in world space, the agent walks straight from one to the next. An empty path stops it.
+	*/
+	void SetPath(int32 AgentIndex, TArray<FVector>&& Waypoints);
+	void SetSpeed(int32 AgentIndex, float Speed);
+
+	// teleports, whatever the agent was doing carries on from there
+	void SetLocation(int32 AgentIndex, const FVector& Location);
+
+	bool IsFollowingPath(int32 AgentIndex) const { return Cursors[AgentIndex] != INDEX_NONE; }
+
+	int32 Num() const { return Components.Num(); }
+
+	// agents that still have waypoints ahead of them, the idle ones don't need a tick
+	int32 NumFollowingPath() const { return NumFollowing; }
+
+	/*
+	* Moves every agent, writes the locations back and then tells the ones that arrived.
+	* Game thread only, OnPathFinished listeners are free to add, remove or redirect agents.
+	*/
+	void Tick(float DeltaSeconds);
+
+	// agents per task, fewer than this aren't worth waking the workers for
+	int32 AgentsPerBatch = 256;
+
+private:
+	TArray<UFGPathFollowingComponent*> Components;
+	TArray<FVector> Locations;
+	TArray<float> Speeds;
+	// next waypoint, INDEX_NONE for agents standing still
+	TArray<int32> Cursors;
+	TArray<TArray<FVector>> Paths;
+	int32 NumFollowing = 0;
+
+	// written by the workers, bytes rather than a bit array so every agent has its own memory location and two
+	// batches never race on the same word. Neighbours at a batch boundary still share a cache line.
+	TArray<uint8> Moved;
+	TArray<uint8> Arrived;
+};
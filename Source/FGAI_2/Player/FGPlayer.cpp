@@ -3,6 +3,7 @@
 #include "Components/InputComponent.h"
 #include "GameFramework/PlayerController.h"
 #include "FGAI_2/Grid/FGGridActor.h"
+#include "FGAI_2/Grid/FGGridSubsystem.h"
 
 #include "Kismet/GameplayStatics.h"
 
@@ -18,13 +19,12 @@ void AFGPlayer::BeginPlay()
 {
 	Super::BeginPlay();
 
-	TArray<AActor*> AllGridActors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AFGGridActor::StaticClass(), AllGridActors);
-
-	if (AllGridActors.Num() > 0)
+	if (UFGGridSubsystem* GridSubsystem = UWorld::GetSubsystem<UFGGridSubsystem>(GetWorld()))
 	{
-		// just pick the first for now
-		CurrentGridActor = Cast<AFGGridActor>(AllGridActors[0]);
+		// the grid under us if there is one, otherwise whatever grid is around
+		CurrentGridActor = GridSubsystem->GetGridAtLocation(GetActorLocation());
+		if (CurrentGridActor == nullptr)
+			CurrentGridActor = GridSubsystem->GetDefaultGrid();
 	}
 
 	
@@ -39,6 +39,7 @@ void AFGPlayer::Tick(float DeltaSeconds)
 	Super::Tick(DeltaSeconds);
 
 	UpdateMovement(DeltaSeconds);
+	UpdatePathPreview();
 }
 
 void AFGPlayer::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -98,6 +99,40 @@ void AFGPlayer::UpdateMovement(float DeltaTime)
 	InputVector = FVector::ZeroVector;
 }
 
+void AFGPlayer::SetPathPreviewStart(int32 Tile)
+{
+	PreviewStartTile = Tile;
+	if (Tile == INDEX_NONE && PreviewPath.Num() > 0)
+	{
+		PreviewPath.Reset();
+		BP_OnPreviewPathChanged();
+	}
+}
+
+void AFGPlayer::UpdatePathPreview()
+{
+	if (PreviewStartTile == INDEX_NONE || CurrentGridActor == nullptr)
+		return;
+
+	// off the grid the preview just clears
+	TArray<int32> NewPath;
+	FVector MouseLocation;
+	int32 GoalX, GoalY, Goal;
+	if (GetMouseLocationOnGrid(MouseLocation)
+		&& CurrentGridActor->GetXYFromWorldLocation(MouseLocation, GoalX, GoalY)
+		&& CurrentGridActor->GetTileIndexFromXY(GoalX, GoalY, Goal))
+	{
+		NewPath = CurrentGridActor->GetPreviewPath(PreviewStartTile, Goal);
+	}
+
+	// mostly the same path as last frame, blueprints only hear about it when it isn't
+	if (NewPath != PreviewPath)
+	{
+		PreviewPath = MoveTemp(NewPath);
+		BP_OnPreviewPathChanged();
+	}
+}
+
 void AFGPlayer::Handle_Forward(float Value)
 {
 	InputVector.X += Value;
@@ -121,11 +156,21 @@ void AFGPlayer::Handle_ConfirmedPressed()
 	{		
 		Tile = CurrentGridActor->GetTileIndexFromWorldLocation(MouseLocation);
 
+		// clicking a wall means the closest tile next to it that can be walked on
+		const int32 FreeTile = CurrentGridActor->FindNearestFreeTile(Tile, NearestFreeTileRadius);
+		if (FreeTile != INDEX_NONE)
+			Tile = FreeTile;
+
 		//ApproachDirs
-		UE_LOG(LogTemp, Warning, TEXT("The boolean value is %s"), ( CurrentGridActor->TileList[Tile].ApproachDirs[0] ? TEXT("true") : TEXT("false") ));
-		UE_LOG(LogTemp, Warning, TEXT("The boolean value is %s"), ( CurrentGridActor->TileList[Tile].ApproachDirs[1] ? TEXT("true") : TEXT("false") ));
-		UE_LOG(LogTemp, Warning, TEXT("The boolean value is %s"), ( CurrentGridActor->TileList[Tile].ApproachDirs[2] ? TEXT("true") : TEXT("false") ));
-		UE_LOG(LogTemp, Warning, TEXT("The boolean value is %s"), ( CurrentGridActor->TileList[Tile].ApproachDirs[3] ? TEXT("true") : TEXT("false") ));
+		const FFGPathGrid& PathGrid = CurrentGridActor->PathGrid;
+		if (PathGrid.JumpTiles.IsValidIndex(Tile))
+		{
+			const FFGJumpTile& JumpTile = PathGrid.JumpTiles[Tile];
+			UE_LOG(LogTemp, Warning, TEXT("The boolean value is %s"), ( JumpTile.ApproachDirs[0] ? TEXT("true") : TEXT("false") ));
+			UE_LOG(LogTemp, Warning, TEXT("The boolean value is %s"), ( JumpTile.ApproachDirs[1] ? TEXT("true") : TEXT("false") ));
+			UE_LOG(LogTemp, Warning, TEXT("The boolean value is %s"), ( JumpTile.ApproachDirs[2] ? TEXT("true") : TEXT("false") ));
+			UE_LOG(LogTemp, Warning, TEXT("The boolean value is %s"), ( JumpTile.ApproachDirs[3] ? TEXT("true") : TEXT("false") ));
+		}
 		UE_LOG(LogTemp, Warning, TEXT("The Tile is %d"), ( Tile));
 
 		int32 X,Y;
@@ -133,10 +178,13 @@ void AFGPlayer::Handle_ConfirmedPressed()
 		UE_LOG(LogTemp, Warning, TEXT("The X is %d"), X);
 		UE_LOG(LogTemp, Warning, TEXT("The Y is %d"), Y);
 
-		auto& DirVals = CurrentGridActor->TileList[Tile].DirectionValues;
-		UE_LOG(LogTemp, Warning, TEXT("%d, %d, %d"), DirVals[Northwest],	DirVals[North], DirVals[Northeast]);
-		UE_LOG(LogTemp, Warning, TEXT("%d, %d, %d"), DirVals[West],			0,				DirVals[East]);
-		UE_LOG(LogTemp, Warning, TEXT("%d, %d, %d"), DirVals[Southwest],	DirVals[South], DirVals[Southeast]);
+		if (PathGrid.JumpTiles.IsValidIndex(Tile))
+		{
+			auto& DirVals = PathGrid.JumpTiles[Tile].DirectionValues;
+			UE_LOG(LogTemp, Warning, TEXT("%d, %d, %d"), DirVals[Northwest],	DirVals[North], DirVals[Northeast]);
+			UE_LOG(LogTemp, Warning, TEXT("%d, %d, %d"), DirVals[West],			0,				DirVals[East]);
+			UE_LOG(LogTemp, Warning, TEXT("%d, %d, %d"), DirVals[Southwest],	DirVals[South], DirVals[Southeast]);
+		}
 	}
 	
 	
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "FGAI_2/AStar/PriorityQueue.h"
+#include "FGAI_2Core/PriorityQueue.h"
 #include "GameFramework/Pawn.h"
 #include "FGPlayer.generated.h"
 
@@ -40,10 +40,30 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Player")
 	bool GetMouseLocationOnGrid(FVector& OutWorldMouseLocation) const;
 
+	// how far from a clicked blocked tile to look for one that isn't
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Player")
+	int32 NearestFreeTileRadius = 8;
+
+	/*
+	* Turns on the path preview from Tile (the selected unit's) to whatever tile the mouse is over, INDEX_NONE turns it off.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Player")
+	void SetPathPreviewStart(int32 Tile);
+
+	/*
+	* Called whenever PreviewPath changed, after the mouse moved onto another tile or the grid changed under it.
+	*/
+	UFUNCTION(BlueprintImplementableEvent, Category = "Player", meta = (DisplayName = "OnPreviewPathChanged"))
+	void BP_OnPreviewPathChanged();
+
+	UPROPERTY(BlueprintReadOnly, Category = "Player")
+	TArray<int32> PreviewPath;
+
 	PriorityQueue<int> PQTest;
 
 private:
 	void UpdateMovement(float DeltaTime);
+	void UpdatePathPreview();
 
 	void Handle_Forward(float Value);
 	void Handle_Right(float Value);
@@ -51,4 +71,6 @@ private:
 	void Handle_ConfirmedPressed();
 
 	FVector InputVector;
+
+	int32 PreviewStartTile = INDEX_NONE;
 };
@@ -0,0 +1,13 @@
+using UnrealBuildTool;
+
+public class FGAI_2Core : ModuleRules
+{
+	public FGAI_2Core(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// Core only on purpose, tools and servers link this without dragging the engine along
+		PublicDependencyModuleNames.AddRange(new string[] { "Core" });
+		PrivateDependencyModuleNames.AddRange(new string[] {  });
+	}
+}
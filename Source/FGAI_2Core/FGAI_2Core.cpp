@@ -0,0 +1,4 @@
+#include "FGAI_2Core.h"
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, FGAI_2Core);
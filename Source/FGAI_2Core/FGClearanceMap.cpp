@@ -0,0 +1,126 @@
+#include "FGClearanceMap.h"
+
+#include "Async/ParallelFor.h"
+#include "FGObstacleGrid.h"
+
+void FFGClearanceMap::Rebuild(const FFGObstacleGrid& Obstacles)
+{
+	Width = Obstacles.Width;
+	Height = Obstacles.Height;
+
+	const int32 NumTiles = Width * Height;
+	Clearance.SetNumUninitialized(NumTiles);
+	if (NumTiles == 0)
+		return;
+
+	// free tiles to the right of and below every tile, itself included, capped like the clearance
+	TArray<uint8> RightRuns;
+	TArray<uint8> DownRuns;
+	RightRuns.SetNumUninitialized(NumTiles);
+	DownRuns.SetNumUninitialized(NumTiles);
+
+	const int32 NumWorkers = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+
+	const int32 RowsPerBand = FMath::Max(16, FMath::DivideAndRoundUp(Height, NumWorkers));
+	ParallelFor(FMath::DivideAndRoundUp(Height, RowsPerBand), [this, &Obstacles, &RightRuns, RowsPerBand](int32 Band)
+	{
+		for (int32 Y = Band * RowsPerBand, MaxY = FMath::Min(Y + RowsPerBand, Height); Y < MaxY; ++Y)
+		{
+			int32 Run = 0;
+			for (int32 X = Width - 1; X >= 0; --X)
+			{
+				Run = Obstacles.IsBlocked(X, Y) ? 0 : FMath::Min(Run + 1, MaxClearance);
+				RightRuns[Y * Width + X] = Run;
+			}
+		}
+	});
+
+	// columns in bands too, walking the rows bottom up keeps every band on contiguous memory
+	const int32 ColumnsPerBand = FMath::Max(64, FMath::DivideAndRoundUp(Width, NumWorkers));
+	ParallelFor(FMath::DivideAndRoundUp(Width, ColumnsPerBand), [this, &Obstacles, &DownRuns, ColumnsPerBand](int32 Band)
+	{
+		const int32 MinX = Band * ColumnsPerBand;
+		const int32 MaxX = FMath::Min(MinX + ColumnsPerBand, Width);
+		for (int32 Y = Height - 1; Y >= 0; --Y)
+		{
+			for (int32 X = MinX; X < MaxX; ++X)
+			{
+				const int32 Below = Y + 1 < Height ? DownRuns[(Y + 1) * Width + X] : 0;
+				DownRuns[Y * Width + X] = Obstacles.IsBlocked(X, Y) ? 0 : FMath::Min(Below + 1, MaxClearance);
+			}
+		}
+	});
+
+	/*
+	* A square at (X, Y) is as big as both runs allow and at most one bigger than the square at (X + 1, Y + 1).
+	* That only ever looks along the diagonal, so every diagonal is its own job.
+	*/
+	const int32 NumDiagonals = Width + Height - 1;
+	const int32 DiagonalsPerBand = FMath::Max(16, FMath::DivideAndRoundUp(NumDiagonals, NumWorkers * 4));
+	ParallelFor(FMath::DivideAndRoundUp(NumDiagonals, DiagonalsPerBand), [this, &RightRuns, &DownRuns, NumDiagonals, DiagonalsPerBand](int32 Band)
+	{
+		for (int32 Diagonal = Band * DiagonalsPerBand, Last = FMath::Min(Diagonal + DiagonalsPerBand, NumDiagonals); Diagonal < Last; ++Diagonal)
+		{
+			// X - Y is constant along a diagonal
+			const int32 Offset = Diagonal - (Height - 1);
+			int32 Y = FMath::Min(Height - 1, Width - 1 - Offset);
+			int32 Square = 0;
+			for (; Y >= 0 && Y + Offset >= 0; --Y)
+			{
+				const int32 TileIndex = Y * Width + Y + Offset;
+				Square = FMath::Min3<int32>(RightRuns[TileIndex], DownRuns[TileIndex], Square + 1);
+				Clearance[TileIndex] = Square;
+			}
+		}
+	});
+}
+
+void FFGClearanceMap::ApplyChanges(const FFGObstacleGrid& Obstacles, const TArray<int32>& ChangedTiles)
+{
+	const int32 NumTiles = Obstacles.Width * Obstacles.Height;
+	if (!IsBuiltFor(Obstacles.Width, Obstacles.Height)
+		|| ChangedTiles.Num() * MaxClearance * MaxClearance > NumTiles / 2)
+	{
+		Rebuild(Obstacles);
+		return;
+	}
+
+	// every square that could cover a changed tile starts at most MaxClearance - 1 up and left of it
+	TArray<int32> DirtyTiles;
+	for (const int32 Changed : ChangedTiles)
+	{
+		const int32 ChangedX = Changed % Width;
+		const int32 ChangedY = Changed / Width;
+		for (int32 Y = FMath::Max(0, ChangedY - MaxClearance + 1); Y <= ChangedY; ++Y)
+		{
+			for (int32 X = FMath::Max(0, ChangedX - MaxClearance + 1); X <= ChangedX; ++X)
+			{
+				DirtyTiles.Add(Y * Width + X);
+			}
+		}
+	}
+
+	/*
+	* A square only depends on the ones right, below and diagonally below of it, all with higher indices.
+	* Going through the dirty tiles from the highest index down, those are always up to date already.
+	*/
+	DirtyTiles.Sort(TGreater<int32>());
+	int32 Previous = INDEX_NONE;
+	for (const int32 TileIndex : DirtyTiles)
+	{
+		if (TileIndex == Previous)
+			continue;
+		Previous = TileIndex;
+
+		const int32 X = TileIndex % Width;
+		const int32 Y = TileIndex / Width;
+		if (Obstacles.IsBlocked(X, Y))
+		{
+			Clearance[TileIndex] = 0;
+			continue;
+		}
+
+		const int32 Smallest = FMath::Min3(GetClearance(X + 1, Y), GetClearance(X, Y + 1), GetClearance(X + 1, Y + 1));
+		Clearance[TileIndex] = FMath::Min(Smallest + 1, MaxClearance);
+	}
+}
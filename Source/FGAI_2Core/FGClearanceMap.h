@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFGObstacleGrid;
+
+/*
+* Per tile the side of the largest free square with the tile as its top left corner (lowest X and Y), 0 on blocks.
+* An agent of size N standing on a tile covers the N x N tiles from there, so it fits wherever the clearance
+* is at least N. One map serves every agent size, see FFGClearanceView.
+* Values are capped at MaxClearance, which also bounds how far a changed tile reaches.
+*/
+struct FGAI_2CORE_API FFGClearanceMap
+{
+	static constexpr int32 MaxClearance = 16;
+
+	/*
+	* Right and down free runs per row and column band, then the squares along the diagonals, all in parallel.
+	*/
+	void Rebuild(const FFGObstacleGrid& Obstacles);
+
+	/*
+	* Only the tiles whose square can reach a changed tile get recomputed, Obstacles already has to be the new state.
+	* Falls back to Rebuild if that would be most of the grid anyway.
+	*/
+	void ApplyChanges(const FFGObstacleGrid& Obstacles, const TArray<int32>& ChangedTiles);
+
+	bool IsBuiltFor(int32 InWidth, int32 InHeight) const
+	{
+		return Width == InWidth && Height == InHeight && InWidth * InHeight > 0 && Clearance.Num() == InWidth * InHeight;
+	}
+
+	// 0 outside the grid
+	FORCEINLINE int32 GetClearance(int32 X, int32 Y) const
+	{
+		if (X < 0 || X >= Width || Y < 0 || Y >= Height)
+			return 0;
+		return Clearance[Y * Width + X];
+	}
+
+	int32 Width = 0;
+	int32 Height = 0;
+
+	TArray<uint8> Clearance;
+};
+
+/*
+* The grid as an agent of AgentSize tiles sees it: every tile it doesn't fit on counts as blocked.
+* Has the part of FFGObstacleGrid's interface the neighborhoods in FGSearchCore.h use, so they search it as is.
+*/
+struct FFGClearanceView
+{
+	const FFGClearanceMap& Map;
+	int32 AgentSize = 1;
+	int32 Width = Map.Width;
+
+	FORCEINLINE bool IsBlocked(int32 X, int32 Y) const { return Map.GetClearance(X, Y) < AgentSize; }
+
+	FORCEINLINE bool IsBlocked(int32 TileIndex) const { return IsBlocked(TileIndex % Width, TileIndex / Width); }
+};
@@ -0,0 +1,256 @@
+#include "FGComponentLabels.h"
+
+#include "Async/ParallelFor.h"
+#include "FGObstacleGrid.h"
+
+namespace
+{
+	// N, NE, E, SE, S, SW, W, NW. Every cell touches the next one, cardinals sit on the even slots.
+	const int32 RingOffsets[8][2] = {{0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}};
+}
+
+void FFGComponentLabels::Rebuild(const FFGObstacleGrid& Obstacles, bool bInEightConnected)
+{
+	bEightConnected = bInEightConnected;
+	Width = Obstacles.Width;
+
+	const int32 Height = Obstacles.Height;
+	const int32 NumTiles = Width * Height;
+
+	Parent.SetNumUninitialized(NumTiles);
+	Size.Init(1, NumTiles);
+	Removed.Init(false, NumTiles);
+
+	if (NumTiles == 0)
+		return;
+
+	/*
+	* Unions inside a band only ever link tiles of that band, so the bands can't step on each other.
+	* The seam rows get stitched together afterwards on this thread.
+	*/
+	const int32 NumWorkers = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+	const int32 RowsPerBand = FMath::Max(16, FMath::DivideAndRoundUp(Height, NumWorkers));
+	const int32 NumBands = FMath::DivideAndRoundUp(Height, RowsPerBand);
+
+	ParallelFor(NumBands, [this, &Obstacles, RowsPerBand, Height](int32 Band)
+	{
+		const int32 MinY = Band * RowsPerBand;
+		const int32 MaxY = FMath::Min(MinY + RowsPerBand, Height);
+
+		for (int32 Y = MinY; Y < MaxY; ++Y)
+		{
+			for (int32 X = 0; X < Width; ++X)
+			{
+				const int32 TileIndex = Y * Width + X;
+				Parent[TileIndex] = Obstacles.IsBlocked(X, Y) ? INDEX_NONE : TileIndex;
+			}
+		}
+
+		for (int32 Y = MinY; Y < MaxY; ++Y)
+		{
+			for (int32 X = 0; X < Width; ++X)
+			{
+				if (Parent[Y * Width + X] != INDEX_NONE)
+					UnionWithNeighbors(Obstacles, X, Y, MinY);
+			}
+		}
+	});
+
+	for (int32 Band = 1; Band < NumBands; ++Band)
+	{
+		const int32 Y = Band * RowsPerBand;
+		for (int32 X = 0; X < Width; ++X)
+		{
+			if (Parent[Y * Width + X] != INDEX_NONE)
+				UnionWithNeighbors(Obstacles, X, Y, Y - 1);
+		}
+	}
+
+	// Flatten so every lookup afterwards is a single hop
+	TArray<int32> Roots;
+	Roots.SetNumUninitialized(NumTiles);
+	ParallelFor(NumBands, [this, &Roots, RowsPerBand, Height](int32 Band)
+	{
+		const int32 MinIndex = Band * RowsPerBand * Width;
+		const int32 MaxIndex = FMath::Min((Band + 1) * RowsPerBand, Height) * Width;
+		for (int32 TileIndex = MinIndex; TileIndex < MaxIndex; ++TileIndex)
+		{
+			Roots[TileIndex] = GetLabel(TileIndex);
+		}
+	});
+	Parent = MoveTemp(Roots);
+}
+
+bool FFGComponentLabels::ApplyChanges(const FFGObstacleGrid& Obstacles, const TArray<int32>& ChangedTiles)
+{
+	if (!IsBuiltFor(Obstacles.Width, Obstacles.Height))
+		return false;
+
+	/*
+	* Blocks first, one at a time, then the frees. That is a valid order to get from the old state to the new one,
+	* and the labels themselves know what was free before, so the ring test sees the right intermediate state.
+	*/
+	TArray<int32, TInlineAllocator<16>> Freed;
+	for (const int32 TileIndex : ChangedTiles)
+	{
+		if (!Obstacles.IsBlocked(TileIndex))
+		{
+			Freed.Add(TileIndex);
+			continue;
+		}
+
+		if (!IsLabeledFree(TileIndex))
+			continue;
+
+		if (!StaysConnectedWithout(Obstacles, TileIndex % Width, TileIndex / Width))
+			return false;
+
+		Removed[TileIndex] = true;
+	}
+
+	for (const int32 TileIndex : Freed)
+	{
+		// No telling what the old subtree hanging off a removed tile is connected to by now
+		if (Removed[TileIndex])
+			return false;
+
+		if (Parent[TileIndex] == INDEX_NONE)
+		{
+			Parent[TileIndex] = TileIndex;
+			Size[TileIndex] = 1;
+		}
+	}
+
+	for (const int32 TileIndex : Freed)
+	{
+		const int32 X = TileIndex % Width;
+		const int32 Y = TileIndex / Width;
+		for (int32 i = 0; i < 8; ++i)
+		{
+			if (!bEightConnected && (i % 2) == 1)
+				continue;
+
+			const int32 NeighborX = X + RingOffsets[i][0];
+			const int32 NeighborY = Y + RingOffsets[i][1];
+			if (!Obstacles.IsInside(NeighborX, NeighborY))
+				continue;
+
+			const int32 NeighborIdx = NeighborY * Width + NeighborX;
+			if (IsLabeledFree(NeighborIdx))
+				Union(TileIndex, NeighborIdx);
+		}
+	}
+
+	return true;
+}
+
+int32 FFGComponentLabels::GetLabel(int32 TileIndex) const
+{
+	if (!Parent.IsValidIndex(TileIndex) || !IsLabeledFree(TileIndex))
+		return INDEX_NONE;
+
+	int32 Current = TileIndex;
+	while (Parent[Current] != Current)
+	{
+		Current = Parent[Current];
+	}
+	return Current;
+}
+
+int32 FFGComponentLabels::FindRoot(int32 TileIndex)
+{
+	while (Parent[TileIndex] != TileIndex)
+	{
+		Parent[TileIndex] = Parent[Parent[TileIndex]];
+		TileIndex = Parent[TileIndex];
+	}
+	return TileIndex;
+}
+
+void FFGComponentLabels::Union(int32 TileA, int32 TileB)
+{
+	int32 RootA = FindRoot(TileA);
+	int32 RootB = FindRoot(TileB);
+	if (RootA == RootB)
+		return;
+
+	if (Size[RootA] < Size[RootB])
+		Swap(RootA, RootB);
+
+	Parent[RootB] = RootA;
+	Size[RootA] += Size[RootB];
+}
+
+void FFGComponentLabels::UnionWithNeighbors(const FFGObstacleGrid& Obstacles, int32 X, int32 Y, int32 MinY)
+{
+	const int32 TileIndex = Y * Width + X;
+
+	if (!Obstacles.IsBlocked(X - 1, Y))
+		Union(TileIndex, TileIndex - 1);
+
+	if (Y - 1 < MinY)
+		return;
+
+	if (!Obstacles.IsBlocked(X, Y - 1))
+		Union(TileIndex, TileIndex - Width);
+
+	if (bEightConnected)
+	{
+		if (!Obstacles.IsBlocked(X - 1, Y - 1))
+			Union(TileIndex, TileIndex - Width - 1);
+		if (!Obstacles.IsBlocked(X + 1, Y - 1))
+			Union(TileIndex, TileIndex - Width + 1);
+	}
+}
+
+bool FFGComponentLabels::StaysConnectedWithout(const FFGObstacleGrid& Obstacles, int32 X, int32 Y) const
+{
+	bool bFree[8];
+	int32 Group[8];
+	for (int32 i = 0; i < 8; ++i)
+	{
+		const int32 RingX = X + RingOffsets[i][0];
+		const int32 RingY = Y + RingOffsets[i][1];
+		bFree[i] = Obstacles.IsInside(RingX, RingY) && IsLabeledFree(RingY * Width + RingX);
+		Group[i] = i;
+	}
+
+	auto FindGroup = [&Group](int32 i)
+	{
+		while (Group[i] != i)
+			i = Group[i];
+		return i;
+	};
+	auto Merge = [&Group, &FindGroup](int32 A, int32 B)
+	{
+		Group[FindGroup(A)] = FindGroup(B);
+	};
+
+	for (int32 i = 0; i < 8; ++i)
+	{
+		if (bFree[i] && bFree[(i + 1) % 8])
+			Merge(i, (i + 1) % 8);
+
+		// two cardinals touch diagonally across a blocked corner
+		if (bEightConnected && (i % 2) == 0 && bFree[i] && bFree[(i + 2) % 8])
+			Merge(i, (i + 2) % 8);
+	}
+
+	/*
+	* The neighbors the tile connected to have to end up in one group around it. If they don't they might still
+	* be connected the long way round, but finding that out is the same work as a rebuild.
+	*/
+	int32 FirstGroup = INDEX_NONE;
+	for (int32 i = 0; i < 8; ++i)
+	{
+		if (!bFree[i] || (!bEightConnected && (i % 2) == 1))
+			continue;
+
+		const int32 ThisGroup = FindGroup(i);
+		if (FirstGroup == INDEX_NONE)
+			FirstGroup = ThisGroup;
+		else if (ThisGroup != FirstGroup)
+			return false;
+	}
+	return true;
+}
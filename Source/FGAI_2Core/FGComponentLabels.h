@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFGObstacleGrid;
+
+/*
+* Connected components of the free tiles as a union-find forest, so "can I get from A to B at all" is two root lookups.
+* Four-connected matches FindPath, JPSRuntime and LazyThetaStar (their diagonals never cut corners, which
+* can't connect anything the cardinals don't). Eight-connected lets diagonal neighbors touch through a corner.
+*/
+struct FGAI_2CORE_API FFGComponentLabels
+{
+	/*
+	* Labels the whole grid, bands of rows in parallel and then the seams between them.
+	*/
+	void Rebuild(const FFGObstacleGrid& Obstacles, bool bInEightConnected);
+
+	/*
+	* Repairs the labels for tiles that flipped since the last update, Obstacles already has to be the new state.
+	* Freed tiles just merge with their neighbors. Blocked tiles only stay cheap if the free tiles around them
+	* are still connected right next to them, otherwise this returns false and the caller has to Rebuild.
+	*/
+	bool ApplyChanges(const FFGObstacleGrid& Obstacles, const TArray<int32>& ChangedTiles);
+
+	bool IsBuiltFor(int32 InWidth, int32 InHeight) const
+	{
+		return Width == InWidth && InWidth * InHeight > 0 && Parent.Num() == InWidth * InHeight;
+	}
+
+	/*
+	* Root tile of the component, INDEX_NONE for blocked tiles. Read only, safe from any thread while nobody updates.
+	*/
+	int32 GetLabel(int32 TileIndex) const;
+
+	bool AreConnected(int32 TileA, int32 TileB) const
+	{
+		const int32 LabelA = GetLabel(TileA);
+		return LabelA != INDEX_NONE && LabelA == GetLabel(TileB);
+	}
+
+	bool bEightConnected = false;
+
+private:
+	int32 FindRoot(int32 TileIndex);
+	void Union(int32 TileA, int32 TileB);
+	void UnionWithNeighbors(const FFGObstacleGrid& Obstacles, int32 X, int32 Y, int32 MinY);
+	bool StaysConnectedWithout(const FFGObstacleGrid& Obstacles, int32 X, int32 Y) const;
+	bool IsLabeledFree(int32 TileIndex) const { return Parent[TileIndex] != INDEX_NONE && !Removed[TileIndex]; }
+
+	int32 Width = 0;
+
+	// INDEX_NONE for tiles that were blocked at the last Rebuild
+	TArray<int32> Parent;
+	TArray<int32> Size;
+
+	/*
+	* Tiles blocked after the last Rebuild without splitting their component. They have to stay in the forest
+	* since other tiles may hang off them, they just don't count as part of it anymore.
+	*/
+	TBitArray<> Removed;
+};
@@ -0,0 +1,79 @@
+#include "FGCostGrid.h"
+#include "FGObstacleGrid.h"
+
+void FFGCostGrid::Build(const TArray<uint8>& TileCosts, const FFGObstacleGrid& Obstacles)
+{
+	Width = Obstacles.Width;
+	Height = Obstacles.Height;
+
+	const int32 NumTiles = Width * Height;
+	Costs.SetNumUninitialized(NumTiles);
+	MinCost = MAX_uint8;
+	for (int32 TileIndex = 0; TileIndex < NumTiles; ++TileIndex)
+	{
+		const uint8 Cost = TileCosts.IsValidIndex(TileIndex) ? FMath::Max<uint8>(TileCosts[TileIndex], 1) : 1;
+		Costs[TileIndex] = Cost;
+		MinCost = FMath::Min(MinCost, Cost);
+	}
+
+	Uniform.Init(false, NumTiles);
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			UpdateUniform(X, Y, Obstacles);
+		}
+	}
+}
+
+void FFGCostGrid::Reset()
+{
+	Width = Height = 0;
+	MinCost = 1;
+	Costs.Reset();
+	Uniform.Empty();
+}
+
+void FFGCostGrid::SetCost(int32 X, int32 Y, uint8 Cost, const FFGObstacleGrid& Obstacles)
+{
+	if (X < 0 || X >= Width || Y < 0 || Y >= Height)
+		return;
+
+	Cost = FMath::Max<uint8>(Cost, 1);
+	Costs[Y * Width + X] = Cost;
+	MinCost = FMath::Min(MinCost, Cost);
+
+	for (int32 NY = FMath::Max(Y - 1, 0); NY <= FMath::Min(Y + 1, Height - 1); ++NY)
+	{
+		for (int32 NX = FMath::Max(X - 1, 0); NX <= FMath::Min(X + 1, Width - 1); ++NX)
+		{
+			UpdateUniform(NX, NY, Obstacles);
+		}
+	}
+}
+
+void FFGCostGrid::UpdateUniform(int32 X, int32 Y, const FFGObstacleGrid& Obstacles)
+{
+	const int32 TileIndex = Y * Width + X;
+	if (Obstacles.IsBlocked(X, Y))
+	{
+		Uniform[TileIndex] = false;
+		return;
+	}
+
+	// blocked neighbors are fine, JPS deals with those through forced neighbors
+	const uint8 Cost = Costs[TileIndex];
+	bool bUniform = true;
+	for (int32 NY = Y - 1; NY <= Y + 1 && bUniform; ++NY)
+	{
+		for (int32 NX = X - 1; NX <= X + 1; ++NX)
+		{
+			if (!Obstacles.IsBlocked(NX, NY) && Costs[NY * Width + NX] != Cost)
+			{
+				bUniform = false;
+				break;
+			}
+		}
+	}
+	Uniform[TileIndex] = bUniform;
+}
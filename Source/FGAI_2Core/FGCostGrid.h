@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFGObstacleGrid;
+
+/*
+* Traversal cost per tile, what it costs to step onto it (1 is plain ground). Kept apart from the obstacles so
+* weighted searches read one byte per tile and nothing else has to care.
+* Also tracks which free tiles sit in a uniform patch, every free tile around them costs the same as they do.
+* Inside those patches a weighted grid behaves like a plain one scaled up, so JPS can keep jumping through them.
+*/
+struct FGAI_2CORE_API FFGCostGrid
+{
+	/*
+	* TileCosts shorter than the grid (old levels) are padded with 1, costs of 0 count as 1.
+	*/
+	void Build(const TArray<uint8>& TileCosts, const FFGObstacleGrid& Obstacles);
+
+	void Reset();
+
+	bool IsValid() const { return Width > 0 && Height > 0; }
+
+	FORCEINLINE uint8 GetCost(int32 TileIndex) const { return Costs[TileIndex]; }
+
+	FORCEINLINE bool IsUniform(int32 TileIndex) const { return Uniform[TileIndex]; }
+
+	/*
+	* Changes one tile and refreshes the uniform flags around it. MinCost only ever goes down here,
+	* a lower bound that is a bit too low still keeps the heuristics admissible.
+	*/
+	void SetCost(int32 X, int32 Y, uint8 Cost, const FFGObstacleGrid& Obstacles);
+
+	int32 Width = 0;
+	int32 Height = 0;
+
+	// cheapest tile on the grid, scales the heuristics
+	uint8 MinCost = 1;
+
+	TArray<uint8> Costs;
+	TBitArray<> Uniform;
+
+private:
+	void UpdateUniform(int32 X, int32 Y, const FFGObstacleGrid& Obstacles);
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+constexpr double Sqrt2 = 1.4142135623730950488016887242097;
+
+// step costs of the searches that mix cardinal and diagonal moves, 14/10 is close enough to sqrt(2)
+constexpr int32 CardinalStepCost = 10;
+constexpr int32 DiagonalStepCost = 14;
+
+struct IVec2
+{
+	int32 x,y;
+
+	bool IsCardinal() const
+	{
+		return (x==0 && y!=0) || (y==0 && x!=0);
+	}
+
+	bool IsDiagonal() const
+	{
+		return x != 0 && y != 0;
+	}
+
+	bool operator==(IVec2 other) const
+	{
+		return (other.x == x) && (other.y == y);
+	}
+
+	IVec2 operator-(IVec2 other) const
+	{
+		return IVec2{x-other.x, y-other.y};
+	}
+};
+
+enum eDir
+{
+	North,
+    South,
+    West,
+    East,
+    Northwest,
+    Northeast,
+    Southwest,
+    Southeast,
+	Nil,
+};
+
+/*
+const IVec2 UpLeft =		{-1,1};
+const IVec2 UpRight =	{1,1};
+const IVec2 DownLeft =	{-1,-1};
+const IVec2 DownRight = {1,-1};
+const IVec2 Up =		{0,1};
+const IVec2 Down =	{0,-1};
+const IVec2 Left =	{-1,0};
+const IVec2 Right =	{1,0};
+*/
+
+enum class EFGPathStatus : uint8
+{
+	Found,
+	// A path exists but didn't fit in the output buffer, the buffer holds its first part starting at the start tile
+	Truncated,
+	NoPath,
+	InvalidTiles,
+	// The query needs preprocessed data that hasn't been built or doesn't match the obstacles anymore
+	MissingData,
+	// The query never ran, the worker threads shut down while it was still queued
+	Aborted,
+};
@@ -0,0 +1,183 @@
+#include "FGInfluenceMap.h"
+
+#include "FGObstacleGrid.h"
+
+void FFGInfluenceMap::SetObstacles(const FFGObstacleGrid& Obstacles)
+{
+	if (Width != Obstacles.Width || Height != Obstacles.Height)
+	{
+		Width = Obstacles.Width;
+		Height = Obstacles.Height;
+		Stride = Align(Width, 4) + 2;
+
+		const int32 PlaneSize = (Height + 2) * Stride;
+		Passable.Init(0.0f, PlaneSize);
+		for (FFGInfluenceLayer& Layer : Layers)
+		{
+			Layer.Current.Init(0.0f, PlaneSize);
+			Layer.Next.Init(0.0f, PlaneSize);
+		}
+		UpdateRow = 0;
+	}
+
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			Passable[(Y + 1) * Stride + X + 1] = Obstacles.IsBlocked(X, Y) ? 0.0f : 1.0f;
+		}
+	}
+}
+
+void FFGInfluenceMap::ApplyTileChanges(const FFGObstacleGrid& Obstacles, const TArray<int32>& ChangedTiles)
+{
+	if (Width != Obstacles.Width || Height != Obstacles.Height)
+	{
+		SetObstacles(Obstacles);
+		return;
+	}
+
+	for (const int32 TileIndex : ChangedTiles)
+	{
+		const int32 X = TileIndex % Width;
+		const int32 Y = TileIndex / Width;
+		Passable[(Y + 1) * Stride + X + 1] = Obstacles.IsBlocked(X, Y) ? 0.0f : 1.0f;
+	}
+}
+
+FFGInfluenceLayer& FFGInfluenceMap::AddLayer(FName Name)
+{
+	if (FFGInfluenceLayer* Existing = FindLayer(Name))
+		return *Existing;
+
+	FFGInfluenceLayer& Layer = Layers.AddDefaulted_GetRef();
+	Layer.Name = Name;
+	Layer.Current.Init(0.0f, (Height + 2) * Stride);
+	Layer.Next.Init(0.0f, (Height + 2) * Stride);
+	return Layer;
+}
+
+FFGInfluenceLayer* FFGInfluenceMap::FindLayer(FName Name)
+{
+	return Layers.FindByPredicate([Name](const FFGInfluenceLayer& Layer) { return Layer.Name == Name; });
+}
+
+const FFGInfluenceLayer* FFGInfluenceMap::FindLayer(FName Name) const
+{
+	return Layers.FindByPredicate([Name](const FFGInfluenceLayer& Layer) { return Layer.Name == Name; });
+}
+
+void FFGInfluenceMap::Stamp(FName Layer, const FFGInfluenceStamp& Stamp)
+{
+	if (FFGInfluenceLayer* Found = FindLayer(Layer))
+		Found->PendingStamps.Add(Stamp);
+}
+
+bool FFGInfluenceMap::RemoveLayer(FName Name)
+{
+	const int32 Index = Layers.IndexOfByPredicate([Name](const FFGInfluenceLayer& Layer) { return Layer.Name == Name; });
+	if (Index == INDEX_NONE)
+		return false;
+
+	Layers.RemoveAt(Index);
+
+	// keep the round robin on the layer it was at, a pass on the removed one just ends
+	if (Index < UpdateLayer)
+		--UpdateLayer;
+	else if (Index == UpdateLayer)
+		UpdateRow = 0;
+
+	if (Layers.Num() == 0)
+	{
+		UpdateLayer = 0;
+		OwedRows = 0.0f;
+	}
+	return true;
+}
+
+void FFGInfluenceMap::Update(float DeltaSeconds, double BudgetSeconds)
+{
+	if (Layers.Num() == 0 || Width == 0 || Height == 0)
+		return;
+
+	// rows are owed at the pass rate, never more than one pass per layer so a long frame can't pile up work
+	const float RowsPerPassRound = static_cast<float>(Height) * Layers.Num();
+	OwedRows = FMath::Min(OwedRows + FMath::Max(DeltaSeconds, 0.0f) * PassesPerSecond * RowsPerPassRound, RowsPerPassRound);
+
+	const double EndTime = FPlatformTime::Seconds() + BudgetSeconds;
+	while (OwedRows >= 1.0f)
+	{
+		UpdateLayer %= Layers.Num();
+		FFGInfluenceLayer& Layer = Layers[UpdateLayer];
+		if (UpdateRow == 0)
+			ApplyStamps(Layer);
+
+		const int32 NumRows = FMath::Min3(FMath::Max(1, RowsPerStep), Height - UpdateRow, FMath::FloorToInt(OwedRows));
+		const int32 LastRow = UpdateRow + NumRows;
+		PropagateRows(Layer, UpdateRow, LastRow);
+		UpdateRow = LastRow;
+		OwedRows -= NumRows;
+
+		// pass done, readers get the new values in one go
+		if (UpdateRow == Height)
+		{
+			Swap(Layer.Current, Layer.Next);
+			UpdateRow = 0;
+			++UpdateLayer;
+		}
+
+		// out of time, the rows still owed carry over
+		if (FPlatformTime::Seconds() >= EndTime)
+			break;
+	}
+}
+
+void FFGInfluenceMap::ApplyStamps(FFGInfluenceLayer& Layer) const
+{
+	for (const FFGInfluenceStamp& Stamp : Layer.PendingStamps)
+	{
+		const int32 Reach = FMath::FloorToInt(Stamp.Radius);
+		const float InvRadius = Stamp.Radius > 0.0f ? 1.0f / Stamp.Radius : 0.0f;
+		for (int32 Y = FMath::Max(0, Stamp.Y - Reach); Y <= FMath::Min(Height - 1, Stamp.Y + Reach); ++Y)
+		{
+			for (int32 X = FMath::Max(0, Stamp.X - Reach); X <= FMath::Min(Width - 1, Stamp.X + Reach); ++X)
+			{
+				const float Distance = FMath::Sqrt(static_cast<float>(FMath::Square(X - Stamp.X) + FMath::Square(Y - Stamp.Y)));
+				const float Weight = 1.0f - Distance * InvRadius;
+				if (Weight <= 0.0f && Distance > 0.0f)
+					continue;
+
+				const int32 Index = (Y + 1) * Stride + X + 1;
+				Layer.Current[Index] += Stamp.Strength * FMath::Max(Weight, 0.0f) * Passable[Index];
+			}
+		}
+	}
+	Layer.PendingStamps.Reset();
+}
+
+void FFGInfluenceMap::PropagateRows(FFGInfluenceLayer& Layer, int32 FirstRow, int32 LastRow) const
+{
+	const VectorRegister FalloffV = VectorSetFloat1(Layer.Falloff * (1.0f - Layer.Momentum));
+	const VectorRegister MomentumV = VectorSetFloat1(Layer.Momentum);
+	const VectorRegister DecayV = VectorSetFloat1(Layer.Decay);
+
+	const float* Current = Layer.Current.GetData();
+	float* Next = Layer.Next.GetData();
+	const float* PassableData = Passable.GetData();
+
+	for (int32 Y = FirstRow; Y < LastRow; ++Y)
+	{
+		// four tiles per step, the lanes past the last column land on the zero padding and stay zero
+		for (int32 Index = (Y + 1) * Stride + 1, RowEnd = Index + Width; Index < RowEnd; Index += 4)
+		{
+			const float* Center = Current + Index;
+			const VectorRegister Strongest = VectorMax(
+				VectorMax(VectorLoad(Center - 1), VectorLoad(Center + 1)),
+				VectorMax(VectorLoad(Center - Stride), VectorLoad(Center + Stride)));
+
+			// Momentum * old + (1 - Momentum) * Falloff * strongest neighbor, then decay and walls
+			const VectorRegister Blended = VectorMultiplyAdd(VectorLoad(Center), MomentumV, VectorMultiply(Strongest, FalloffV));
+			VectorStore(VectorMultiply(VectorMultiply(Blended, DecayV), VectorLoad(PassableData + Index)), Next + Index);
+		}
+	}
+}
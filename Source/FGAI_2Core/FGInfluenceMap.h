@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFGObstacleGrid;
+
+/*
+* Influence added around a tile, falling off linearly to nothing at Radius tiles.
+*/
+struct FFGInfluenceStamp
+{
+	int32 X = 0;
+	int32 Y = 0;
+	float Radius = 0.0f;
+	float Strength = 0.0f;
+};
+
+/*
+* One float per tile, e.g. enemy threat or ally presence, meant to stay positive. The planes have a border
+* of zeros and rows padded to whole SIMD vectors, so the kernels never check bounds. Current is what readers
+* see, Next is where the pass in progress writes.
+*/
+struct FGAI_2CORE_API FFGInfluenceLayer
+{
+	FName Name;
+
+	// share of the strongest neighbor that flows into a tile per pass, see FFGInfluenceMap::PassesPerSecond
+	float Falloff = 0.8f;
+
+	// how much of its old value a tile keeps per pass, 0 takes the propagated value right away
+	float Momentum = 0.5f;
+
+	// everything gets scaled by this per pass, so influence nobody stamps anymore fades out
+	float Decay = 0.95f;
+
+	TArray<float> Current;
+	TArray<float> Next;
+
+	// stamps that came in since the pass in progress started, they land when the next one starts
+	TArray<FFGInfluenceStamp> PendingStamps;
+};
+
+/*
+* Influence layers over one grid and the work to keep them moving. Every pass over a layer spreads
+* each tile's strongest neighbor into it, blends with the old value and decays. Passes are cut into row steps
+* so Update can stop wherever its time budget runs out and carry on next frame. Walls don't let influence through.
+* Not thread safe, the owning grid updates and reads it on the game thread.
+*/
+class FGAI_2CORE_API FFGInfluenceMap
+{
+public:
+	/*
+	* Sizes every layer for the grid and refreshes which tiles influence flows through.
+	* Layers keep their values as long as the size stays the same.
+	*/
+	void SetObstacles(const FFGObstacleGrid& Obstacles);
+	void ApplyTileChanges(const FFGObstacleGrid& Obstacles, const TArray<int32>& ChangedTiles);
+
+	/*
+	* Returns the layer of that name, a new empty one if there is none yet.
+	* References and pointers to layers don't survive adding another one.
+	*/
+	FFGInfluenceLayer& AddLayer(FName Name);
+
+	// false if there was no such layer, other layers keep their values and the update carries on with them
+	bool RemoveLayer(FName Name);
+
+	FFGInfluenceLayer* FindLayer(FName Name);
+	const FFGInfluenceLayer* FindLayer(FName Name) const;
+
+	int32 NumLayers() const { return Layers.Num(); }
+
+	bool IsBuiltFor(int32 InWidth, int32 InHeight) const { return Width == InWidth && Height == InHeight && Width > 0; }
+
+	void Stamp(FName Layer, const FFGInfluenceStamp& Stamp);
+
+	FORCEINLINE float GetValue(const FFGInfluenceLayer& Layer, int32 X, int32 Y) const
+	{
+		return Layer.Current[(Y + 1) * Stride + X + 1];
+	}
+
+	FORCEINLINE float GetValue(const FFGInfluenceLayer& Layer, int32 TileIndex) const
+	{
+		return GetValue(Layer, TileIndex % Width, TileIndex / Width);
+	}
+
+	/*
+	* Passes come due at PassesPerSecond per layer, so how far influence spreads and how fast it fades depend on
+	* time and not on frame rate or CPU speed. Works through what is due round robin, RowsPerStep rows at a time,
+	* until it is done or BudgetSeconds are used up, whatever is left carries over. Never more than one pass per
+	* layer per call. A call with a full row due always does at least one step, so a tiny budget still gets somewhere.
+	*/
+	void Update(float DeltaSeconds, double BudgetSeconds);
+
+	int32 RowsPerStep = 8;
+	float PassesPerSecond = 10.0f;
+
+private:
+	void ApplyStamps(FFGInfluenceLayer& Layer) const;
+	void PropagateRows(FFGInfluenceLayer& Layer, int32 FirstRow, int32 LastRow) const;
+
+	int32 Width = 0;
+	int32 Height = 0;
+	// floats per padded row: the width rounded up to whole vectors plus a zero on each side
+	int32 Stride = 0;
+
+	// same layout as the layers, 1 for free tiles and 0 for blocks and the border
+	TArray<float> Passable;
+
+	TArray<FFGInfluenceLayer> Layers;
+
+	// where the pass in progress is
+	int32 UpdateLayer = 0;
+	int32 UpdateRow = 0;
+	// rows due but not propagated yet, over all layers
+	float OwedRows = 0.0f;
+};
@@ -0,0 +1,121 @@
+#include "FGObstacleGrid.h"
+
+void FFGObstacleGrid::Build(int32 InWidth, int32 InHeight, TFunctionRef<bool(int32)> IsTileBlocked)
+{
+	Width = InWidth;
+	Height = InHeight;
+	WordsPerRow = (InWidth + 63) >> 6;
+	Words.Init(0, WordsPerRow * InHeight);
+	Hash = static_cast<uint64>(InWidth) << 32 | static_cast<uint32>(InHeight);
+
+	const int32 NumTiles = InWidth * InHeight;
+	for (int32 TileIndex = 0; TileIndex < NumTiles; ++TileIndex)
+	{
+		if (IsTileBlocked(TileIndex))
+		{
+			const int32 X = TileIndex % InWidth;
+			const int32 Y = TileIndex / InWidth;
+			Words[Y * WordsPerRow + (X >> 6)] |= uint64(1) << (X & 63);
+			Hash ^= HashTile(TileIndex);
+		}
+	}
+}
+
+void FFGObstacleGrid::Reset()
+{
+	Width = Height = WordsPerRow = 0;
+	Hash = 0;
+	Words.Reset();
+}
+
+void FFGObstacleGrid::SetBlocked(int32 X, int32 Y, bool bBlocked)
+{
+	if (!IsInside(X, Y))
+		return;
+
+	uint64& Word = Words[Y * WordsPerRow + (X >> 6)];
+	const uint64 Mask = uint64(1) << (X & 63);
+	if (((Word & Mask) != 0) != bBlocked)
+		Hash ^= HashTile(Y * Width + X);
+
+	if (bBlocked)
+		Word |= Mask;
+	else
+		Word &= ~Mask;
+}
+
+bool FFGObstacleGrid::IsRowSpanFree(int32 Y, int32 X0, int32 X1) const
+{
+	if (X0 > X1)
+		Swap(X0, X1);
+
+	if (!IsInside(X0, Y) || !IsInside(X1, Y))
+		return false;
+
+	const uint64* Row = &Words[Y * WordsPerRow];
+	const int32 FirstWord = X0 >> 6;
+	const int32 LastWord = X1 >> 6;
+
+	for (int32 WordIndex = FirstWord; WordIndex <= LastWord; ++WordIndex)
+	{
+		uint64 Mask = ~uint64(0);
+		if (WordIndex == FirstWord)
+			Mask &= ~uint64(0) << (X0 & 63);
+		if (WordIndex == LastWord)
+			Mask &= ~uint64(0) >> (63 - (X1 & 63));
+
+		if (Row[WordIndex] & Mask)
+			return false;
+	}
+	return true;
+}
+
+bool FFGObstacleGrid::HasLineOfSight(int32 X0, int32 Y0, int32 X1, int32 Y1) const
+{
+	if (Y0 == Y1)
+		return IsRowSpanFree(Y0, X0, X1);
+
+	int32 DX = FMath::Abs(X1 - X0);
+	int32 DY = FMath::Abs(Y1 - Y0);
+	const int32 StepX = X1 > X0 ? 1 : -1;
+	const int32 StepY = Y1 > Y0 ? 1 : -1;
+
+	int32 X = X0;
+	int32 Y = Y0;
+	int32 Error = DX - DY;
+	DX *= 2;
+	DY *= 2;
+
+	for (int32 Steps = 1 + (DX + DY) / 2; Steps > 0; --Steps)
+	{
+		if (IsBlocked(X, Y))
+			return false;
+
+		// arrived, whatever lies past the target doesn't matter
+		if (X == X1 && Y == Y1)
+			return true;
+
+		if (Error > 0)
+		{
+			X += StepX;
+			Error -= DY;
+		}
+		else if (Error < 0)
+		{
+			Y += StepY;
+			Error += DX;
+		}
+		else
+		{
+			// Exactly through a corner
+			if (IsBlocked(X + StepX, Y) || IsBlocked(X, Y + StepY))
+				return false;
+
+			X += StepX;
+			Y += StepY;
+			Error += DX - DY;
+			--Steps;
+		}
+	}
+	return true;
+}
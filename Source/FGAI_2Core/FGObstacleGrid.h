@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Bit-packed obstacle map, one bit per tile. Every row starts on a fresh 64 bit word
+* so whole row spans can be tested a word at a time. Anything outside the grid counts as blocked.
+*/
+struct FGAI_2CORE_API FFGObstacleGrid
+{
+	/*
+	* IsTileBlocked gets asked once per tile index, so any per-tile storage can be packed without a copy.
+	*/
+	void Build(int32 InWidth, int32 InHeight, TFunctionRef<bool(int32)> IsTileBlocked);
+
+	void Reset();
+
+	bool IsValid() const { return Width > 0 && Height > 0; }
+
+	FORCEINLINE bool IsInside(int32 X, int32 Y) const
+	{
+		return X >= 0 && X < Width && Y >= 0 && Y < Height;
+	}
+
+	FORCEINLINE bool IsBlocked(int32 X, int32 Y) const
+	{
+		if (!IsInside(X, Y))
+			return true;
+		return ((Words[Y * WordsPerRow + (X >> 6)] >> (X & 63)) & 1) != 0;
+	}
+
+	FORCEINLINE bool IsBlocked(int32 TileIndex) const
+	{
+		return IsBlocked(TileIndex % Width, TileIndex / Width);
+	}
+
+	void SetBlocked(int32 X, int32 Y, bool bBlocked);
+
+	/*
+	* True if every tile between X0 and X1 (inclusive, any order) in row Y is free.
+	*/
+	bool IsRowSpanFree(int32 Y, int32 X0, int32 X1) const;
+
+	/*
+	* Supercover line between the two tile centers, every tile the segment touches has to be free.
+	* When the line passes exactly through a corner both tiles beside it need to be free, no corner cutting.
+	*/
+	bool HasLineOfSight(int32 X0, int32 Y0, int32 X1, int32 Y1) const;
+
+	/*
+	* Order independent hash of the blocked tiles, SetBlocked keeps it up to date. Preprocessed data stores it
+	* to notice when the obstacles it was built from changed.
+	*/
+	static uint64 HashTile(int32 TileIndex)
+	{
+		uint64 Value = static_cast<uint64>(TileIndex) + 0x9E3779B97F4A7C15ull;
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 WordsPerRow = 0;
+	uint64 Hash = 0;
+	TArray<uint64> Words;
+};
@@ -0,0 +1,107 @@
+#include "FGObstacleImport.h"
+
+FFGObstacleImporter::FFGObstacleImporter(int32 InGridWidth, int32 InGridHeight, int32 InPixelWidth, int32 InPixelHeight,
+                                         const FFGObstacleImportRules& InRules)
+	: GridWidth(FMath::Max(InGridWidth, 0))
+	, GridHeight(FMath::Max(InGridHeight, 0))
+	, PixelWidth(FMath::Max(InPixelWidth, 1))
+	, PixelHeight(FMath::Max(InPixelHeight, 1))
+	, Rules(InRules)
+{
+	ColumnBegins.SetNumUninitialized(GridWidth);
+	ColumnEnds.SetNumUninitialized(GridWidth);
+	for (int32 X = 0; X < GridWidth; ++X)
+	{
+		ColumnBegins[X] = RangeBegin(X, PixelWidth, GridWidth);
+		ColumnEnds[X] = RangeEnd(X, PixelWidth, GridWidth);
+	}
+
+	PreviousHeights.SetNumZeroed(GridWidth);
+	CurrentHeights.SetNumZeroed(GridWidth);
+	BlockedTiles.Init(false, GridWidth * GridHeight);
+}
+
+void FFGObstacleImporter::AddPixelRows(TArrayView<const uint16> Pixels)
+{
+	check(Pixels.Num() % PixelWidth == 0);
+
+	const int32 NumRows = FMath::Min(Pixels.Num() / PixelWidth, PixelHeight - NumPixelRowsAdded);
+	PixelBuffer.Append(Pixels.GetData(), NumRows * PixelWidth);
+	NumPixelRowsAdded += NumRows;
+
+	// every tile row whose pixels are all here now
+	while (NextTileRow < GridHeight && RangeEnd(NextTileRow, PixelHeight, GridHeight) <= NumPixelRowsAdded)
+	{
+		FinishTileRow();
+	}
+}
+
+void FFGObstacleImporter::FinishTileRow()
+{
+	constexpr float ToHeight = 1.0f / MAX_uint16;
+
+	const int32 Y = NextTileRow;
+	const int32 RowBegin = RangeBegin(Y, PixelHeight, GridHeight);
+	const int32 RowEnd = RangeEnd(Y, PixelHeight, GridHeight);
+
+	Swap(PreviousHeights, CurrentHeights);
+	for (int32 X = 0; X < GridWidth; ++X)
+	{
+		uint32 Lowest = MAX_uint16;
+		uint32 Highest = 0;
+		uint64 Sum = 0;
+		for (int32 Row = RowBegin; Row < RowEnd; ++Row)
+		{
+			const uint16* RowPixels = PixelBuffer.GetData() + (Row - FirstBufferedRow) * PixelWidth;
+			for (int32 Column = ColumnBegins[X]; Column < ColumnEnds[X]; ++Column)
+			{
+				const uint32 Pixel = RowPixels[Column];
+				Lowest = FMath::Min(Lowest, Pixel);
+				Highest = FMath::Max(Highest, Pixel);
+				Sum += Pixel;
+			}
+		}
+
+		const int32 NumPixels = (RowEnd - RowBegin) * (ColumnEnds[X] - ColumnBegins[X]);
+		CurrentHeights[X] = static_cast<float>(Sum) / NumPixels * ToHeight;
+
+		const int32 TileIndex = Y * GridWidth + X;
+		if (Highest * ToHeight > Rules.BlockAbove || Lowest * ToHeight < Rules.BlockBelow)
+			Block(TileIndex);
+	}
+
+	if (Rules.MaxStep >= 0.0f)
+	{
+		for (int32 X = 0; X < GridWidth; ++X)
+		{
+			if (X > 0 && FMath::Abs(CurrentHeights[X] - CurrentHeights[X - 1]) > Rules.MaxStep)
+			{
+				Block(Y * GridWidth + X);
+				Block(Y * GridWidth + X - 1);
+			}
+			if (Y > 0 && FMath::Abs(CurrentHeights[X] - PreviousHeights[X]) > Rules.MaxStep)
+			{
+				Block(Y * GridWidth + X);
+				Block((Y - 1) * GridWidth + X);
+			}
+		}
+	}
+
+	// the next tile row starts at or after this one's first pixel row, anything above it is done with
+	++NextTileRow;
+	const int32 KeepFrom = NextTileRow < GridHeight ? RangeBegin(NextTileRow, PixelHeight, GridHeight) : NumPixelRowsAdded;
+	if (KeepFrom > FirstBufferedRow)
+	{
+		PixelBuffer.RemoveAt(0, (KeepFrom - FirstBufferedRow) * PixelWidth, false);
+		FirstBufferedRow = KeepFrom;
+	}
+}
+
+void FFGObstacleImporter::Block(int32 TileIndex)
+{
+	if (!BlockedTiles[TileIndex])
+	{
+		BlockedTiles[TileIndex] = true;
+		++NumBlocked;
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* What makes an imported tile blocked. Heights are the source's samples scaled to 0..1, a tile looks at every
+* pixel it covers: it blocks if its highest pixel is above BlockAbove, its lowest below BlockBelow, or its average
+* height differs from a side neighbor's by more than MaxStep (both tiles block then, it's the edge between them
+* that can't be walked). The defaults read a black and white mask, white being walls.
+*/
+struct FFGObstacleImportRules
+{
+	float BlockAbove = 0.5f;
+	float BlockBelow = -1.0f;
+	// negative turns the slope rule off
+	float MaxStep = -1.0f;
+};
+
+/*
+* Turns a grayscale image or heightmap into blocked tiles while it streams in, without ever holding the whole
+* image: pixel rows get added in chunks of any size, and only the rows the current tile row still needs are kept.
+* Images of any size map onto the grid, smaller ones get their pixels stretched over several tiles.
+*/
+class FGAI_2CORE_API FFGObstacleImporter
+{
+public:
+	FFGObstacleImporter(int32 InGridWidth, int32 InGridHeight, int32 InPixelWidth, int32 InPixelHeight,
+	                    const FFGObstacleImportRules& InRules);
+
+	/*
+	* The next rows of the image from the top, 16 bits per pixel (8 bit sources times 257).
+	* The chunk has to hold whole rows.
+	*/
+	void AddPixelRows(TArrayView<const uint16> Pixels);
+
+	bool IsComplete() const { return NextTileRow == GridHeight; }
+
+	/*
+	* One bit per tile, tile index order. Final once IsComplete.
+	*/
+	const TBitArray<>& GetBlockedTiles() const { return BlockedTiles; }
+
+	int32 GetNumBlocked() const { return NumBlocked; }
+
+private:
+	// first pixel row or column a tile row or column covers, Begin(N + 1) ends it but always covers at least one
+	static int32 RangeBegin(int32 Tile, int32 NumPixels, int32 NumTiles)
+	{
+		return static_cast<int32>(static_cast<int64>(Tile) * NumPixels / NumTiles);
+	}
+
+	static int32 RangeEnd(int32 Tile, int32 NumPixels, int32 NumTiles)
+	{
+		return FMath::Max(RangeBegin(Tile + 1, NumPixels, NumTiles), RangeBegin(Tile, NumPixels, NumTiles) + 1);
+	}
+
+	void FinishTileRow();
+	void Block(int32 TileIndex);
+
+	int32 GridWidth;
+	int32 GridHeight;
+	int32 PixelWidth;
+	int32 PixelHeight;
+	FFGObstacleImportRules Rules;
+
+	// the pixel columns of every tile column, worked out once
+	TArray<int32> ColumnBegins;
+	TArray<int32> ColumnEnds;
+
+	// pixel rows from FirstBufferedRow on that some tile row still needs
+	TArray<uint16> PixelBuffer;
+	int32 FirstBufferedRow = 0;
+	int32 NumPixelRowsAdded = 0;
+
+	int32 NextTileRow = 0;
+
+	// average heights of the last finished tile row and the one being finished, for the slope rule
+	TArray<float> PreviousHeights;
+	TArray<float> CurrentHeights;
+
+	TBitArray<> BlockedTiles;
+	int32 NumBlocked = 0;
+};
@@ -0,0 +1,316 @@
+#include "FGOccupancyGrid.h"
+
+#include "FGObstacleGrid.h"
+
+void FFGOccupancyGrid::Init(int32 InWidth, int32 InHeight)
+{
+	Width = FMath::Max(InWidth, 0);
+	Height = FMath::Max(InHeight, 0);
+	BlocksX = (Width + BlockSize - 1) >> BlockShift;
+	BlocksY = (Height + BlockSize - 1) >> BlockShift;
+
+	TileCounts.Reset();
+	TileCounts.SetNumZeroed(Width * Height);
+	// the old indices don't mean the same tiles anymore, the owner has to move everybody back on
+	for (int32 Handle = 0; Handle < OccupantTiles.Num(); ++Handle)
+	{
+		OccupantTiles[Handle] = INDEX_NONE;
+		EntryIndices[Handle] = INDEX_NONE;
+	}
+
+	BlockStarts.Reset();
+	BlockStarts.SetNumZeroed(BlocksX * BlocksY + 1);
+	Entries.Reset();
+	bDirty = false;
+}
+
+int32 FFGOccupancyGrid::GetBlock(int32 TileIndex) const
+{
+	if (TileIndex < 0 || TileIndex >= TileCounts.Num())
+		return INDEX_NONE;
+
+	const int32 X = TileIndex % Width;
+	const int32 Y = TileIndex / Width;
+	return (Y >> BlockShift) * BlocksX + (X >> BlockShift);
+}
+
+int32 FFGOccupancyGrid::AddOccupant(int32 TileIndex, int32 Type)
+{
+	int32 Handle;
+	if (FreeHandles.Num() > 0)
+	{
+		Handle = FreeHandles.Pop(false);
+		Live[Handle] = true;
+	}
+	else
+	{
+		Handle = OccupantTiles.AddUninitialized();
+		OccupantTypes.AddUninitialized();
+		EntryIndices.AddUninitialized();
+		Live.Add(true);
+	}
+
+	OccupantTiles[Handle] = INDEX_NONE;
+	OccupantTypes[Handle] = Type;
+	EntryIndices[Handle] = INDEX_NONE;
+	MoveOccupant(Handle, TileIndex);
+	return Handle;
+}
+
+void FFGOccupancyGrid::RemoveOccupant(int32 Handle)
+{
+	if (!IsValidOccupant(Handle))
+		return;
+
+	MoveOccupant(Handle, INDEX_NONE);
+	Live[Handle] = false;
+	FreeHandles.Add(Handle);
+}
+
+void FFGOccupancyGrid::MoveOccupant(int32 Handle, int32 TileIndex)
+{
+	if (TileIndex < 0 || TileIndex >= TileCounts.Num())
+		TileIndex = INDEX_NONE;
+
+	int32& Tile = OccupantTiles[Handle];
+	if (Tile == TileIndex)
+		return;
+
+	if (Tile != INDEX_NONE)
+		--TileCounts[Tile];
+	if (TileIndex != INDEX_NONE)
+		++TileCounts[TileIndex];
+
+	// same block, the entry just gets its new tile
+	const int32 EntryIndex = EntryIndices[Handle];
+	if (!bDirty && EntryIndex != INDEX_NONE && TileIndex != INDEX_NONE && GetBlock(Tile) == GetBlock(TileIndex))
+		Entries[EntryIndex].Tile = TileIndex;
+	else
+		bDirty = true;
+
+	Tile = TileIndex;
+}
+
+void FFGOccupancyGrid::Update()
+{
+	if (!bDirty)
+		return;
+
+	// counting sort by block
+	const int32 NumBlocks = BlocksX * BlocksY;
+	BlockStarts.Reset();
+	BlockStarts.SetNumZeroed(NumBlocks + 1);
+	for (int32 Handle = 0; Handle < OccupantTiles.Num(); ++Handle)
+	{
+		const int32 Block = Live[Handle] ? GetBlock(OccupantTiles[Handle]) : INDEX_NONE;
+		if (Block != INDEX_NONE)
+			++BlockStarts[Block + 1];
+	}
+	for (int32 Block = 0; Block < NumBlocks; ++Block)
+	{
+		BlockStarts[Block + 1] += BlockStarts[Block];
+	}
+
+	Entries.SetNumUninitialized(BlockStarts[NumBlocks]);
+	TArray<int32> Cursors(BlockStarts.GetData(), NumBlocks);
+	for (int32 Handle = 0; Handle < OccupantTiles.Num(); ++Handle)
+	{
+		const int32 Block = Live[Handle] ? GetBlock(OccupantTiles[Handle]) : INDEX_NONE;
+		if (Block == INDEX_NONE)
+		{
+			EntryIndices[Handle] = INDEX_NONE;
+			continue;
+		}
+
+		const int32 EntryIndex = Cursors[Block]++;
+		Entries[EntryIndex] = {OccupantTiles[Handle], OccupantTypes[Handle], Handle};
+		EntryIndices[Handle] = EntryIndex;
+	}
+
+	bDirty = false;
+}
+
+int32 FFGOccupancyGrid::GetNumOnTile(int32 TileIndex) const
+{
+	return TileCounts.IsValidIndex(TileIndex) ? TileCounts[TileIndex] : 0;
+}
+
+void FFGOccupancyGrid::GetOccupantsOnTile(int32 TileIndex, TArray<int32>& OutHandles) const
+{
+	check(!bDirty);
+
+	if (GetNumOnTile(TileIndex) == 0)
+		return;
+
+	const int32 Block = GetBlock(TileIndex);
+	for (int32 EntryIndex = BlockStarts[Block]; EntryIndex < BlockStarts[Block + 1]; ++EntryIndex)
+	{
+		if (Entries[EntryIndex].Tile == TileIndex)
+			OutHandles.Add(Entries[EntryIndex].Handle);
+	}
+}
+
+void FFGOccupancyGrid::FindOccupantsInRadius(int32 TileIndex, int32 Radius, int32 Type, TArray<int32>& OutHandles) const
+{
+	check(!bDirty);
+
+	if (GetBlock(TileIndex) == INDEX_NONE || Radius < 0)
+		return;
+
+	const int32 OriginX = TileIndex % Width;
+	const int32 OriginY = TileIndex / Width;
+	const int32 MinBlockX = FMath::Max(OriginX - Radius, 0) >> BlockShift;
+	const int32 MaxBlockX = FMath::Min(OriginX + Radius, Width - 1) >> BlockShift;
+	const int32 MinBlockY = FMath::Max(OriginY - Radius, 0) >> BlockShift;
+	const int32 MaxBlockY = FMath::Min(OriginY + Radius, Height - 1) >> BlockShift;
+	const int32 RadiusSquared = Radius * Radius;
+
+	for (int32 BlockY = MinBlockY; BlockY <= MaxBlockY; ++BlockY)
+	{
+		for (int32 BlockX = MinBlockX; BlockX <= MaxBlockX; ++BlockX)
+		{
+			const int32 Block = BlockY * BlocksX + BlockX;
+			for (int32 EntryIndex = BlockStarts[Block]; EntryIndex < BlockStarts[Block + 1]; ++EntryIndex)
+			{
+				const FEntry& Entry = Entries[EntryIndex];
+				if (Type != INDEX_NONE && Entry.Type != Type)
+					continue;
+
+				const int32 DeltaX = Entry.Tile % Width - OriginX;
+				const int32 DeltaY = Entry.Tile / Width - OriginY;
+				if (DeltaX * DeltaX + DeltaY * DeltaY <= RadiusSquared)
+					OutHandles.Add(Entry.Handle);
+			}
+		}
+	}
+}
+
+int32 FFGOccupancyGrid::FindNearestOccupant(int32 TileIndex, int32 Type, int32 MaxRadius) const
+{
+	check(!bDirty);
+
+	const int32 OriginBlock = GetBlock(TileIndex);
+	if (OriginBlock == INDEX_NONE || MaxRadius < 0)
+		return INDEX_NONE;
+
+	const int32 OriginX = TileIndex % Width;
+	const int32 OriginY = TileIndex / Width;
+	const int32 OriginBlockX = OriginBlock % BlocksX;
+	const int32 OriginBlockY = OriginBlock / BlocksX;
+	const int32 MaxRing = FMath::Min((MaxRadius >> BlockShift) + 1, FMath::Max(BlocksX, BlocksY));
+
+	int32 BestHandle = INDEX_NONE;
+	int32 BestDistanceSquared = MaxRadius * MaxRadius + 1;
+	int32 BestTile = MAX_int32;
+
+	auto VisitBlock = [&](int32 BlockX, int32 BlockY)
+	{
+		if (BlockX < 0 || BlockX >= BlocksX || BlockY < 0 || BlockY >= BlocksY)
+			return;
+
+		const int32 Block = BlockY * BlocksX + BlockX;
+		for (int32 EntryIndex = BlockStarts[Block]; EntryIndex < BlockStarts[Block + 1]; ++EntryIndex)
+		{
+			const FEntry& Entry = Entries[EntryIndex];
+			if (Type != INDEX_NONE && Entry.Type != Type)
+				continue;
+
+			const int32 DeltaX = Entry.Tile % Width - OriginX;
+			const int32 DeltaY = Entry.Tile / Width - OriginY;
+			const int32 DistanceSquared = DeltaX * DeltaX + DeltaY * DeltaY;
+			if (DistanceSquared < BestDistanceSquared || (DistanceSquared == BestDistanceSquared && Entry.Tile < BestTile))
+			{
+				BestHandle = Entry.Handle;
+				BestDistanceSquared = DistanceSquared;
+				BestTile = Entry.Tile;
+			}
+		}
+	};
+
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		// every tile in this ring of blocks is at least this far away along one axis
+		const int32 MinDistance = FMath::Max(Ring - 1, 0) * BlockSize + (Ring > 0 ? 1 : 0);
+		if (MinDistance * MinDistance > BestDistanceSquared)
+			break;
+
+		if (Ring == 0)
+		{
+			VisitBlock(OriginBlockX, OriginBlockY);
+			continue;
+		}
+
+		for (int32 Offset = -Ring; Offset <= Ring; ++Offset)
+		{
+			VisitBlock(OriginBlockX + Offset, OriginBlockY - Ring);
+			VisitBlock(OriginBlockX + Offset, OriginBlockY + Ring);
+		}
+		for (int32 Offset = -Ring + 1; Offset < Ring; ++Offset)
+		{
+			VisitBlock(OriginBlockX - Ring, OriginBlockY + Offset);
+			VisitBlock(OriginBlockX + Ring, OriginBlockY + Offset);
+		}
+	}
+
+	return BestHandle;
+}
+
+int32 FFGOccupancyGrid::FindNearestFreeTile(const FFGObstacleGrid& Obstacles, int32 TileIndex, int32 MaxRadius, bool bAllowOccupied) const
+{
+	const int32 GridWidth = Obstacles.Width;
+	if (GridWidth <= 0 || TileIndex < 0 || TileIndex >= GridWidth * Obstacles.Height || MaxRadius < 0)
+		return INDEX_NONE;
+
+	const int32 OriginX = TileIndex % GridWidth;
+	const int32 OriginY = TileIndex / GridWidth;
+	// occupancy for a grid of some other size is no help
+	const bool bCheckOccupied = !bAllowOccupied && GridWidth == Width && Obstacles.Height == Height;
+	const int32 MaxRadiusSquared = MaxRadius * MaxRadius;
+
+	int32 BestTile = INDEX_NONE;
+	int32 BestDistanceSquared = MaxRadiusSquared + 1;
+
+	auto VisitTile = [&](int32 X, int32 Y)
+	{
+		if (Obstacles.IsBlocked(X, Y))
+			return;
+
+		const int32 Tile = Y * GridWidth + X;
+		if (bCheckOccupied && TileCounts[Tile] > 0)
+			return;
+
+		const int32 DistanceSquared = (X - OriginX) * (X - OriginX) + (Y - OriginY) * (Y - OriginY);
+		if (DistanceSquared < BestDistanceSquared || (DistanceSquared == BestDistanceSquared && Tile < BestTile))
+		{
+			BestTile = Tile;
+			BestDistanceSquared = DistanceSquared;
+		}
+	};
+
+	const int32 MaxRing = FMath::Min(MaxRadius, FMath::Max(GridWidth, Obstacles.Height));
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		// nothing in this ring is closer than Ring tiles
+		if (Ring * Ring > BestDistanceSquared)
+			break;
+
+		if (Ring == 0)
+		{
+			VisitTile(OriginX, OriginY);
+			continue;
+		}
+
+		for (int32 Offset = -Ring; Offset <= Ring; ++Offset)
+		{
+			VisitTile(OriginX + Offset, OriginY - Ring);
+			VisitTile(OriginX + Offset, OriginY + Ring);
+		}
+		for (int32 Offset = -Ring + 1; Offset < Ring; ++Offset)
+		{
+			VisitTile(OriginX - Ring, OriginY + Offset);
+			VisitTile(OriginX + Ring, OriginY + Offset);
+		}
+	}
+
+	return BestTile;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFGObstacleGrid;
+
+/*
+* Who stands where. Occupants are handles with a tile and a game defined type, bucketed by blocks of
+* BlockSize x BlockSize tiles: one block's occupants sit next to each other in memory, and re-bucketing
+* after moves only sorts blocks instead of touching every tile. Moves within a block are patched in place.
+*
+* Adding, removing and moving just records the change, Update re-buckets. The queries read the buckets
+* and need an up to date grid, game thread only like everything else that edits it.
+*/
+struct FGAI_2CORE_API FFGOccupancyGrid
+{
+	static constexpr int32 BlockShift = 3;
+	static constexpr int32 BlockSize = 1 << BlockShift;
+
+	/*
+	* Occupants stay registered but are taken off the grid, the owner has to move them back on.
+	*/
+	void Init(int32 InWidth, int32 InHeight);
+
+	bool IsBuiltFor(int32 InWidth, int32 InHeight) const { return Width == InWidth && Height == InHeight && BlockStarts.Num() > 0; }
+
+	/*
+	* TileIndex may be INDEX_NONE (or anything outside the grid) for an occupant that isn't on the grid right now.
+	* Returns the handle, handles of removed occupants get reused.
+	*/
+	int32 AddOccupant(int32 TileIndex, int32 Type);
+	void RemoveOccupant(int32 Handle);
+	void MoveOccupant(int32 Handle, int32 TileIndex);
+
+	bool IsValidOccupant(int32 Handle) const { return Live.IsValidIndex(Handle) && Live[Handle]; }
+	int32 GetOccupantTile(int32 Handle) const { return OccupantTiles[Handle]; }
+	int32 GetOccupantType(int32 Handle) const { return OccupantTypes[Handle]; }
+	int32 NumOccupants() const { return OccupantTiles.Num() - FreeHandles.Num(); }
+
+	/*
+	* Re-buckets if anything changed block since the last update, cheap otherwise.
+	*/
+	void Update();
+	bool IsUpToDate() const { return !bDirty; }
+
+	int32 GetNumOnTile(int32 TileIndex) const;
+	bool IsOccupied(int32 TileIndex) const { return GetNumOnTile(TileIndex) > 0; }
+
+	/*
+	* The queries below append handles. Type INDEX_NONE matches every type, distances are between tile centers.
+	*/
+	void GetOccupantsOnTile(int32 TileIndex, TArray<int32>& OutHandles) const;
+	void FindOccupantsInRadius(int32 TileIndex, int32 Radius, int32 Type, TArray<int32>& OutHandles) const;
+
+	/*
+	* Closest occupant of Type within MaxRadius tiles, INDEX_NONE if there is none.
+	* Searches rings of blocks outwards and stops as soon as no further ring can hold anything closer.
+	*/
+	int32 FindNearestOccupant(int32 TileIndex, int32 Type, int32 MaxRadius) const;
+
+	/*
+	* Closest tile that isn't blocked (and with bAllowOccupied false isn't occupied either) within MaxRadius tiles,
+	* TileIndex itself if it qualifies. Rings of tiles outwards, INDEX_NONE if nothing qualifies.
+	* Ties go to the lower tile index so the answer doesn't depend on scan order.
+	*/
+	int32 FindNearestFreeTile(const FFGObstacleGrid& Obstacles, int32 TileIndex, int32 MaxRadius, bool bAllowOccupied) const;
+
+private:
+	struct FEntry
+	{
+		int32 Tile;
+		int32 Type;
+		int32 Handle;
+	};
+
+	int32 GetBlock(int32 TileIndex) const;
+
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 BlocksX = 0;
+	int32 BlocksY = 0;
+
+	// per handle, tile is INDEX_NONE while off the grid
+	TArray<int32> OccupantTiles;
+	TArray<int32> OccupantTypes;
+	// where the handle's entry is, INDEX_NONE if it has none
+	TArray<int32> EntryIndices;
+	TBitArray<> Live;
+	TArray<int32> FreeHandles;
+
+	// kept up to date on every change, not just by Update
+	TArray<uint16> TileCounts;
+
+	// entries grouped by block, block B owns [BlockStarts[B], BlockStarts[B + 1])
+	TArray<int32> BlockStarts;
+	TArray<FEntry> Entries;
+
+	bool bDirty = false;
+};
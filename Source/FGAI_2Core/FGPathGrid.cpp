@@ -0,0 +1,846 @@
+#include "FGPathGrid.h"
+
+#include "Algo/BinarySearch.h"
+#include "Algo/Reverse.h"
+#include "Async/ParallelFor.h"
+
+const IVec2 FFGPathGrid::Directions[9] = {
+	{0,-1}, //North
+	{0,1},  //South
+	{-1,0}, //West
+	{1,0},  //East
+	{-1,-1},//NorthWest
+	{1,-1}, //NorthEast
+	{-1,1}, //SouthWest
+	{1,1},  //SouthEast
+	{0,0}
+};
+
+namespace
+{
+	/*
+	* JPSRuntime's successors, straight out of the distances JPSPreProcess stored per tile and direction.
+	* The goal gets returned directly when it lies within a jump, otherwise the next jump point if there is one.
+	*/
+	struct FFGJumpNeighborhood
+	{
+		const FFGPathGrid& Grid;
+		int32 Goal;
+		int32 GoalX;
+		int32 GoalY;
+		bool bGoalBounded = false;
+
+		struct SearchDirs
+		{
+			int32 NumValidDirs;
+			eDir ValidDirs[8];
+		};
+
+		// by travel direction, in eDir order
+		static const SearchDirs ValidDirLookup[9];
+
+		template <typename VisitType>
+		void ForEachSuccessor(int32 TileIndex, int32 ParentTile, VisitType&& Visit) const
+		{
+			const int32 Width = Grid.Width;
+			const int32 CurrentX = TileIndex % Width;
+			const int32 CurrentY = TileIndex / Width;
+
+			//get directions to check from travel direction
+			const SearchDirs* ValidDirections = &ValidDirLookup[eDir::Nil];
+			if (ParentTile != -1)
+			{
+				const IVec2 TravelDirection = {
+					FMath::Clamp(CurrentX - ParentTile % Width, -1, 1),
+					FMath::Clamp(CurrentY - ParentTile / Width, -1, 1)
+				};
+				for (int i = 0; i < 8; ++i)
+				{
+					if (FFGPathGrid::Directions[i] == TravelDirection)
+					{
+						ValidDirections = &ValidDirLookup[i];
+						break;
+					}
+				}
+			}
+
+			const FFGJumpTile& TileInfo = Grid.JumpTiles[TileIndex];
+			const IVec2 GoalDiff = {GoalX - CurrentX, GoalY - CurrentY};
+			const IVec2 GoalDir = {FMath::Clamp(GoalDiff.x, -1, 1), FMath::Clamp(GoalDiff.y, -1, 1)};
+			const int32 RowDiffToGoal = FMath::Abs(GoalDiff.x);
+			const int32 ColDiffToGoal = FMath::Abs(GoalDiff.y);
+			const bool bGoalStraightAhead = GoalDiff.x == 0 || GoalDiff.y == 0 || RowDiffToGoal == ColDiffToGoal;
+
+			for (int32 DirIdx = 0; DirIdx < ValidDirections->NumValidDirs; ++DirIdx)
+			{
+				const eDir ValidDirection = ValidDirections->ValidDirs[DirIdx];
+				// no shortest path to the goal starts out this way
+				if (bGoalBounded && !TileInfo.GoalBounds[ValidDirection].Contains(GoalX, GoalY))
+					continue;
+
+				const IVec2 DirectionVector = FFGPathGrid::Directions[ValidDirection];
+				const int32 DistanceOfThisDirection = FMath::Abs(TileInfo.DirectionValues[ValidDirection]);
+				const bool bGoalInGeneralDirection = GoalDir == DirectionVector;
+
+				if (DirectionVector.IsCardinal() && bGoalInGeneralDirection && bGoalStraightAhead
+					&& RowDiffToGoal + ColDiffToGoal <= DistanceOfThisDirection)
+				{
+					Visit(Goal, CardinalStepCost * (RowDiffToGoal + ColDiffToGoal));
+				}
+				else if (DirectionVector.IsDiagonal() && bGoalInGeneralDirection
+					&& (RowDiffToGoal <= DistanceOfThisDirection || ColDiffToGoal <= DistanceOfThisDirection))
+				{
+					// as far diagonally as the goal's row or column
+					const int32 MinDiff = FMath::Min(RowDiffToGoal, ColDiffToGoal);
+					Visit((CurrentY + DirectionVector.y * MinDiff) * Width + CurrentX + DirectionVector.x * MinDiff,
+					      DiagonalStepCost * MinDiff);
+				}
+				else if (TileInfo.DirectionValues[ValidDirection] > 0) //there is a jump point in this direction
+				{
+					Visit((CurrentY + DirectionVector.y * DistanceOfThisDirection) * Width
+					      + CurrentX + DirectionVector.x * DistanceOfThisDirection,
+					      (DirectionVector.IsDiagonal() ? DiagonalStepCost : CardinalStepCost) * DistanceOfThisDirection);
+				}
+			}
+		}
+	};
+
+	/*
+	* Plain JPS for the grid an agent of some size sees, jumping as it goes. Same jump points as the
+	* JPSPreProcess data would have for that grid: cardinal jumps stop past a corner that opens up beside them,
+	* diagonal ones wherever a cardinal jump from there finds something. The goal stops every jump.
+	*/
+	template <typename ObstacleType>
+	struct TFGOnlineJumpNeighborhood
+	{
+		const ObstacleType& Obstacles;
+		int32 Goal;
+
+		bool IsForced(int32 X, int32 Y, IVec2 Dir) const
+		{
+			// the tiles beside us, and the ones beside the tile we came from
+			const IVec2 Side = {Dir.y, Dir.x};
+			return (Obstacles.IsBlocked(X - Dir.x + Side.x, Y - Dir.y + Side.y) && !Obstacles.IsBlocked(X + Side.x, Y + Side.y))
+				|| (Obstacles.IsBlocked(X - Dir.x - Side.x, Y - Dir.y - Side.y) && !Obstacles.IsBlocked(X - Side.x, Y - Side.y));
+		}
+
+		// steps to the next jump point or the goal, 0 if there is none
+		int32 JumpCardinal(int32 X, int32 Y, IVec2 Dir) const
+		{
+			const int32 Width = Obstacles.Width;
+			for (int32 Steps = 1;; ++Steps)
+			{
+				X += Dir.x;
+				Y += Dir.y;
+				if (Obstacles.IsBlocked(X, Y))
+					return 0;
+				if (Y * Width + X == Goal || IsForced(X, Y, Dir))
+					return Steps;
+			}
+		}
+
+		int32 JumpDiagonal(int32 X, int32 Y, IVec2 Dir) const
+		{
+			const int32 Width = Obstacles.Width;
+			for (int32 Steps = 1;; ++Steps)
+			{
+				// no corner cutting
+				if (Obstacles.IsBlocked(X + Dir.x, Y) || Obstacles.IsBlocked(X, Y + Dir.y) || Obstacles.IsBlocked(X + Dir.x, Y + Dir.y))
+					return 0;
+				X += Dir.x;
+				Y += Dir.y;
+				if (Y * Width + X == Goal || JumpCardinal(X, Y, {Dir.x, 0}) > 0 || JumpCardinal(X, Y, {0, Dir.y}) > 0)
+					return Steps;
+			}
+		}
+
+		template <typename VisitType>
+		void ForEachSuccessor(int32 TileIndex, int32 ParentTile, VisitType&& Visit) const
+		{
+			const int32 Width = Obstacles.Width;
+			const int32 CurrentX = TileIndex % Width;
+			const int32 CurrentY = TileIndex / Width;
+
+			const FFGJumpNeighborhood::SearchDirs* ValidDirections = &FFGJumpNeighborhood::ValidDirLookup[eDir::Nil];
+			if (ParentTile != -1)
+			{
+				const IVec2 TravelDirection = {
+					FMath::Clamp(CurrentX - ParentTile % Width, -1, 1),
+					FMath::Clamp(CurrentY - ParentTile / Width, -1, 1)
+				};
+				for (int i = 0; i < 8; ++i)
+				{
+					if (FFGPathGrid::Directions[i] == TravelDirection)
+					{
+						ValidDirections = &FFGJumpNeighborhood::ValidDirLookup[i];
+						break;
+					}
+				}
+			}
+
+			for (int32 DirIdx = 0; DirIdx < ValidDirections->NumValidDirs; ++DirIdx)
+			{
+				const IVec2 Dir = FFGPathGrid::Directions[ValidDirections->ValidDirs[DirIdx]];
+				const int32 Steps = Dir.IsDiagonal() ? JumpDiagonal(CurrentX, CurrentY, Dir) : JumpCardinal(CurrentX, CurrentY, Dir);
+				if (Steps > 0)
+				{
+					Visit((CurrentY + Dir.y * Steps) * Width + CurrentX + Dir.x * Steps,
+					      (Dir.IsDiagonal() ? DiagonalStepCost : CardinalStepCost) * Steps);
+				}
+			}
+		}
+	};
+
+	const FFGJumpNeighborhood::SearchDirs FFGJumpNeighborhood::ValidDirLookup[9] = {
+		{5, {eDir::East, eDir::Northeast, eDir::North, eDir::Northwest, eDir::West}},
+		{5, {eDir::West, eDir::Southwest, eDir::South, eDir::Southeast, eDir::East}},
+		{5, {eDir::North, eDir::Northwest, eDir::West, eDir::Southwest, eDir::South}},
+		{5, {eDir::South, eDir::Southeast, eDir::East, eDir::Northeast, eDir::North}},
+		{3, {eDir::North, eDir::Northwest, eDir::West}},
+		{3, {eDir::East, eDir::Northeast, eDir::North}},
+		{3, {eDir::West, eDir::Southwest, eDir::South}},
+		{3, {eDir::South, eDir::Southeast, eDir::East}},
+		{8, {eDir::North, eDir::South, eDir::West, eDir::East, eDir::Northwest, eDir::Northeast, eDir::Southwest, eDir::Southeast}}
+	};
+}
+
+void FFGPathGrid::SetObstacles(int32 InWidth, int32 InHeight, TFunctionRef<bool(int32)> IsTileBlocked,
+                               const TArray<uint8>& TileCosts)
+{
+	Width = InWidth;
+	Height = InHeight;
+	ObstacleGrid.Build(InWidth, InHeight, IsTileBlocked);
+	// the uniform patches depend on where the obstacles are as well
+	CostGrid.Build(TileCosts, ObstacleGrid);
+}
+
+void FFGPathGrid::Build(int32 InWidth, int32 InHeight, TFunctionRef<bool(int32)> IsTileBlocked,
+                        const TArray<uint8>& TileCosts)
+{
+	SetObstacles(InWidth, InHeight, IsTileBlocked, TileCosts);
+	RebuildComponentLabels();
+	RebuildClearance();
+	JPSPreProcess();
+}
+
+void FFGPathGrid::RebuildComponentLabels()
+{
+	ComponentLabels4.Rebuild(ObstacleGrid, false);
+	ComponentLabels8.Rebuild(ObstacleGrid, true);
+}
+
+void FFGPathGrid::RebuildClearance()
+{
+	Clearance.Rebuild(ObstacleGrid);
+}
+
+void FFGPathGrid::ApplyTileChanges(const TArray<int32>& ChangedTiles)
+{
+	if (ChangedTiles.Num() == 0)
+		return;
+
+	// bulk edits like an obstacle import, repairing tile by tile would cost more than starting over
+	if (ChangedTiles.Num() > GetNumTiles() / 8)
+	{
+		RebuildComponentLabels();
+		RebuildClearance();
+		return;
+	}
+
+	Clearance.ApplyChanges(ObstacleGrid, ChangedTiles);
+
+	if (!ComponentLabels4.ApplyChanges(ObstacleGrid, ChangedTiles))
+		ComponentLabels4.Rebuild(ObstacleGrid, false);
+	if (!ComponentLabels8.ApplyChanges(ObstacleGrid, ChangedTiles))
+		ComponentLabels8.Rebuild(ObstacleGrid, true);
+}
+
+void FFGPathGrid::ClearJumpData()
+{
+	++JumpRevision;
+	JumpTiles.Reset();
+	bHasGoalBounds = false;
+}
+
+void FFGPathGrid::JPSPreProcess()
+{
+	FindPrimaryJumpPoints();
+	SweepCardinalJumps();
+	SweepDiagonalJumps();
+}
+
+void FFGPathGrid::FindPrimaryJumpPoints()
+{
+	++JumpRevision;
+	const int32 NumTiles = GetNumTiles();
+	JumpTiles.Reset();
+	JumpTiles.SetNum(NumTiles);
+	bHasGoalBounds = false;
+
+	auto IsObstacle = [this](int32 X, int32 Y)
+	{
+		return ObstacleGrid.IsBlocked(X, Y);
+	};
+
+	struct BlockCase
+	{
+		IVec2 Offset;
+		struct
+		{
+			IVec2 N;
+			eDir Dir;
+		} FNCase1;
+		struct
+		{
+			IVec2 N;
+			eDir Dir;
+		} FNCase2;
+	};
+
+	const BlockCase Cases[4] = {
+		{Directions[Northwest],{Directions[North], East},{Directions[West],South}},
+		{Directions[Northeast],{Directions[North], West},{Directions[East], South}},
+		{Directions[Southwest],{Directions[West], North},{Directions[South], East}},
+		{Directions[Southeast],{Directions[East], North},{Directions[South], West}}
+	};
+
+	for (int TileIndex = 0; TileIndex < NumTiles; ++TileIndex)
+	{
+		const int32 CX = TileIndex % Width;
+		const int32 CY = TileIndex / Width;
+
+		for (int j = 0; j < 4; ++j)
+		{
+			const IVec2 BlockAt = {CX + Cases[j].Offset.x, CY + Cases[j].Offset.y};
+			if (!ObstacleGrid.IsInside(BlockAt.x, BlockAt.y) || !IsObstacle(BlockAt.x, BlockAt.y))
+				continue;
+
+			if (!IsObstacle(CX + Cases[j].FNCase1.N.x, CY + Cases[j].FNCase1.N.y))
+			{
+				const IVec2 ApproachDir = Directions[Cases[j].FNCase1.Dir];
+				if (!IsObstacle(CX - ApproachDir.x, CY - ApproachDir.y))
+					JumpTiles[TileIndex].ApproachDirs[Cases[j].FNCase1.Dir] = true;
+			}
+			if (!IsObstacle(CX + Cases[j].FNCase2.N.x, CY + Cases[j].FNCase2.N.y))
+			{
+				const IVec2 ApproachDir = Directions[Cases[j].FNCase2.Dir];
+				if (!IsObstacle(CX - ApproachDir.x, CY - ApproachDir.y))
+					JumpTiles[TileIndex].ApproachDirs[Cases[j].FNCase2.Dir] = true;
+			}
+		}
+	}
+}
+
+void FFGPathGrid::SweepCardinalJumps()
+{
+	++JumpRevision;
+	auto IsObstacle = [this](int32 X, int32 Y)
+	{
+		return ObstacleGrid.IsBlocked(X, Y);
+	};
+
+	auto CardinalSweep = [this, &IsObstacle](const int32 X, const int32 Y,
+	                                         eDir Dir, int32& Distance, bool& jumpPointLastSeen)
+	{
+		FFGJumpTile& Tile = JumpTiles[Y * Width + X];
+
+		if (IsObstacle(X, Y))
+		{
+			Distance = -1;
+			jumpPointLastSeen = false;
+			Tile.DirectionValues[Dir] = 0;
+			return;
+		}
+
+		Distance = Distance + 1;
+
+		if (jumpPointLastSeen)
+			Tile.DirectionValues[Dir] = Distance;
+		else
+			Tile.DirectionValues[Dir] = -Distance;
+
+		if (Tile.ApproachDirs[Dir]) //this is a jump point for this direction
+		{
+			Distance = 0;
+			jumpPointLastSeen = true;
+		}
+	};
+
+	//SweepRight_WestwardValues
+	for (int Y = 0; Y < Height; ++Y)
+	{
+		int32 Distance = -1;
+		bool bJumpPointLastSeen = false;
+		for (int X = 0; X < Width; ++X)
+			CardinalSweep(X, Y, eDir::West, Distance, bJumpPointLastSeen);
+	}
+
+	//SweepLeft_EastwardValues
+	for (int Y = 0; Y < Height; ++Y)
+	{
+		int32 Distance = -1;
+		bool bJumpPointLastSeen = false;
+		for (int X = Width - 1; X >= 0; --X)
+			CardinalSweep(X, Y, eDir::East, Distance, bJumpPointLastSeen);
+	}
+
+	//SweepDown_NorthwardValues
+	for (int X = 0; X < Width; ++X)
+	{
+		int32 Distance = -1;
+		bool bJumpPointLastSeen = false;
+		for (int Y = 0; Y < Height; ++Y)
+			CardinalSweep(X, Y, eDir::North, Distance, bJumpPointLastSeen);
+	}
+
+	//SweepUp_SouthwardValues
+	for (int X = 0; X < Width; ++X)
+	{
+		int32 Distance = -1;
+		bool bJumpPointLastSeen = false;
+		for (int Y = Height - 1; Y >= 0; --Y)
+			CardinalSweep(X, Y, eDir::South, Distance, bJumpPointLastSeen);
+	}
+}
+
+void FFGPathGrid::SweepDiagonalJumps()
+{
+	++JumpRevision;
+	auto IsObstacle = [this](int32 X, int32 Y)
+	{
+		return ObstacleGrid.IsBlocked(X, Y);
+	};
+
+	auto DiagonalSweep = [this, &IsObstacle](const int32 X, const int32 Y,
+	                                         eDir Vertical, eDir Horizontal, eDir Diagonal, FFGJumpTile& CurrentTileInfo)
+	{
+		const IVec2 DiagonalOffset = Directions[Diagonal];
+
+		if (IsObstacle(X, Y + DiagonalOffset.y)
+			|| IsObstacle(X + DiagonalOffset.x, Y) || IsObstacle(X + DiagonalOffset.x, Y + DiagonalOffset.y))
+		{
+			CurrentTileInfo.DirectionValues[Diagonal] = 0;
+			return;
+		}
+
+		// the previous tile along the diagonal is inside the grid, otherwise it would count as an obstacle above
+		const FFGJumpTile& PrevTile = JumpTiles[(Y + DiagonalOffset.y) * Width + X + DiagonalOffset.x];
+		if (PrevTile.DirectionValues[Vertical] > 0 || PrevTile.DirectionValues[Horizontal] > 0)
+		{
+			CurrentTileInfo.DirectionValues[Diagonal] = 1;
+		}
+		else
+		{
+			const int32 JumpDistance = PrevTile.DirectionValues[Diagonal];
+			if (JumpDistance > 0)
+			{
+				CurrentTileInfo.DirectionValues[Diagonal] = 1 + JumpDistance;
+			}
+			else
+			{
+				CurrentTileInfo.DirectionValues[Diagonal] = -1 + JumpDistance;
+			}
+		}
+	};
+
+	for (int Y = Height - 1; Y >= 0; --Y)
+	{
+		for (int X = 0; X < Width; ++X)
+		{
+			if (!IsObstacle(X, Y))
+			{
+				FFGJumpTile& Tile = JumpTiles[Y * Width + X];
+				DiagonalSweep(X, Y, eDir::South, eDir::West, eDir::Southwest, Tile);
+				DiagonalSweep(X, Y, eDir::South, eDir::East, eDir::Southeast, Tile);
+			}
+		}
+	}
+
+	for (int Y = 0; Y < Height; ++Y)
+	{
+		for (int X = 0; X < Width; ++X)
+		{
+			if (!IsObstacle(X, Y))
+			{
+				FFGJumpTile& Tile = JumpTiles[Y * Width + X];
+				DiagonalSweep(X, Y, eDir::North, eDir::West, eDir::Northwest, Tile);
+				DiagonalSweep(X, Y, eDir::North, eDir::East, eDir::Northeast, Tile);
+			}
+		}
+	}
+}
+
+void FFGPathGrid::BuildGoalBounds()
+{
+	++JumpRevision;
+	bHasGoalBounds = false;
+	// the bounds keep their coordinates in 16 bits
+	if (!HasJumpData() || Width > MAX_uint16 || Height > MAX_uint16)
+		return;
+
+	const int32 NumTiles = GetNumTiles();
+	ParallelFor(Height, [this, NumTiles](int32 Y)
+	{
+		// one scratch per row, warm for every flood after the first
+		TArray<int32> GScores;
+		TArray<uint8> FirstMoves;
+		PriorityQueue<int32, int32> OpenQueue;
+		OpenQueue.Reserve(NumTiles);
+		const TFGEightNeighborhood<false> Neighborhood{ObstacleGrid};
+
+		for (int32 X = 0; X < Width; ++X)
+		{
+			const int32 Start = Y * Width + X;
+			FFGTileBounds* Bounds = JumpTiles[Start].GoalBounds;
+
+			// searches can start on a block, they just don't get pruned there
+			if (ObstacleGrid.IsBlocked(X, Y))
+			{
+				for (int32 Dir = 0; Dir < 8; ++Dir)
+				{
+					Bounds[Dir].Add(0, 0);
+					Bounds[Dir].Add(Width - 1, Height - 1);
+				}
+				continue;
+			}
+
+			GScores.Init(MAX_int32, NumTiles);
+			FirstMoves.Init(0, NumTiles);
+			OpenQueue.Reset();
+			GScores[Start] = 0;
+			OpenQueue.PrioritisedAdd(Start, 0);
+
+			while (OpenQueue.Num() > 0)
+			{
+				const int32 Current = OpenQueue.PopFirst();
+				const int32 CurrentGScore = GScores[Current];
+				const uint8 CurrentMoves = FirstMoves[Current];
+
+				// every shortest way here has been relaxed by now, so the moves are complete
+				for (int32 Dir = 0; Dir < 8; ++Dir)
+				{
+					if (CurrentMoves & (1 << Dir))
+						Bounds[Dir].Add(Current % Width, Current / Width);
+				}
+
+				Neighborhood.ForEachSuccessor(Current, -1,
+					[this, &GScores, &FirstMoves, &OpenQueue, Start, X, Y, Current, CurrentGScore, CurrentMoves](int32 Successor, int32 StepCost)
+					{
+						uint8 Moves = CurrentMoves;
+						if (Current == Start)
+						{
+							const IVec2 Offset = {Successor % Width - X, Successor / Width - Y};
+							for (int32 Dir = 0; Dir < 8; ++Dir)
+							{
+								if (Directions[Dir] == Offset)
+									Moves = 1 << Dir;
+							}
+						}
+
+						// ties keep every first move, one of them might be the only one JPS is allowed to take
+						const int32 NewGScore = CurrentGScore + StepCost;
+						if (NewGScore == GScores[Successor])
+						{
+							FirstMoves[Successor] |= Moves;
+							return;
+						}
+						if (NewGScore > GScores[Successor])
+							return;
+
+						GScores[Successor] = NewGScore;
+						FirstMoves[Successor] = Moves;
+						if (OpenQueue.Contains(Successor))
+							OpenQueue.UpdatePriority(Successor, NewGScore);
+						else
+							OpenQueue.PrioritisedAdd(Successor, NewGScore);
+					});
+			}
+		}
+	});
+
+	bHasGoalBounds = true;
+}
+
+bool FFGPathGrid::IsGoalUnreachable(int32 Start, int32 Goal) const
+{
+	if (!ComponentLabels4.IsBuiltFor(Width, Height))
+		return false;
+
+	const int32 GoalLabel = ComponentLabels4.GetLabel(Goal);
+	if (GoalLabel == INDEX_NONE)
+		return true;
+
+	const int32 StartLabel = ComponentLabels4.GetLabel(Start);
+	return StartLabel != INDEX_NONE && StartLabel != GoalLabel;
+}
+
+EFGPathStatus FFGPathGrid::FindPath(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+                                    FFGSearchScratch& Scratch) const
+{
+	OutPathLength = 0;
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal))
+		return EFGPathStatus::InvalidTiles;
+
+	if (IsGoalUnreachable(Start, Goal))
+		return EFGPathStatus::NoPath;
+
+	Scratch.Prepare(GetNumTiles());
+	const TFGFourNeighborhood<> Neighborhood{ObstacleGrid};
+	const TFGManhattanHeuristic<> Heuristic{Width, Goal % Width, Goal / Width};
+	if (!RunGridSearch(Neighborhood, Heuristic, Start, Goal, Scratch))
+		return EFGPathStatus::NoPath;
+
+	return ConstructPath(Scratch.Parent, Goal, OutPath, OutPathLength);
+}
+
+EFGPathStatus FFGPathGrid::JPSRuntime(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+                                      FFGSearchScratch& Scratch) const
+{
+	OutPathLength = 0;
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal))
+		return EFGPathStatus::InvalidTiles;
+
+	if (!HasJumpData())
+		return EFGPathStatus::MissingData;
+
+	if (IsGoalUnreachable(Start, Goal))
+		return EFGPathStatus::NoPath;
+
+	Scratch.Prepare(GetNumTiles());
+	const FFGJumpNeighborhood Neighborhood{*this, Goal, Goal % Width, Goal / Width, HasGoalBounds()};
+	const TFGOctileHeuristic<> Heuristic{Width, Goal % Width, Goal / Width};
+	if (!RunGridSearch(Neighborhood, Heuristic, Start, Goal, Scratch))
+		return EFGPathStatus::NoPath;
+
+	return ConstructPath(Scratch.Parent, Goal, OutPath, OutPathLength);
+}
+
+EFGPathStatus FFGPathGrid::ConstructPath(const TArray<int32>& Parent, int32 Goal, TArrayView<int32> OutPath,
+                                         int32& OutPathLength) const
+{
+	int32 PathLength = 0;
+	for (int32 CurrentIdx = Goal; CurrentIdx != -1; CurrentIdx = Parent[CurrentIdx])
+	{
+		++PathLength;
+	}
+
+	//walking back from the goal, so fill from the back and drop whatever doesn't fit at the goal end
+	int32 WriteIdx = PathLength - 1;
+	for (int32 CurrentIdx = Goal; CurrentIdx != -1; CurrentIdx = Parent[CurrentIdx], --WriteIdx)
+	{
+		if (WriteIdx < OutPath.Num())
+			OutPath[WriteIdx] = CurrentIdx;
+	}
+
+	OutPathLength = PathLength;
+	return PathLength <= OutPath.Num() ? EFGPathStatus::Found : EFGPathStatus::Truncated;
+}
+
+EFGPathStatus FFGPathGrid::FindPathForSize(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+                                           int32& OutPathLength, FFGSearchScratch& Scratch) const
+{
+	if (AgentSize <= 1)
+		return FindPath(Start, Goal, OutPath, OutPathLength, Scratch);
+
+	OutPathLength = 0;
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal))
+		return EFGPathStatus::InvalidTiles;
+
+	if (AgentSize > FFGClearanceMap::MaxClearance || !Clearance.IsBuiltFor(Width, Height))
+		return EFGPathStatus::MissingData;
+
+	// a big agent can't get anywhere a small one can't
+	const FFGClearanceView View{Clearance, AgentSize};
+	if (IsGoalUnreachable(Start, Goal) || View.IsBlocked(Goal))
+		return EFGPathStatus::NoPath;
+
+	Scratch.Prepare(GetNumTiles());
+	const TFGFourNeighborhood<int32, FFGClearanceView> Neighborhood{View};
+	const TFGManhattanHeuristic<> Heuristic{Width, Goal % Width, Goal / Width};
+	if (!RunGridSearch(Neighborhood, Heuristic, Start, Goal, Scratch))
+		return EFGPathStatus::NoPath;
+
+	return ConstructPath(Scratch.Parent, Goal, OutPath, OutPathLength);
+}
+
+EFGPathStatus FFGPathGrid::JPSRuntimeForSize(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+                                             int32& OutPathLength, FFGSearchScratch& Scratch) const
+{
+	if (AgentSize <= 1)
+		return JPSRuntime(Start, Goal, OutPath, OutPathLength, Scratch);
+
+	OutPathLength = 0;
+	if (!IsTileIndexValid(Start) || !IsTileIndexValid(Goal))
+		return EFGPathStatus::InvalidTiles;
+
+	if (AgentSize > FFGClearanceMap::MaxClearance || !Clearance.IsBuiltFor(Width, Height))
+		return EFGPathStatus::MissingData;
+
+	const FFGClearanceView View{Clearance, AgentSize};
+	if (IsGoalUnreachable(Start, Goal) || View.IsBlocked(Goal))
+		return EFGPathStatus::NoPath;
+
+	Scratch.Prepare(GetNumTiles());
+	const TFGOnlineJumpNeighborhood<FFGClearanceView> Neighborhood{View, Goal};
+	const TFGOctileHeuristic<> Heuristic{Width, Goal % Width, Goal / Width};
+	if (!RunGridSearch(Neighborhood, Heuristic, Start, Goal, Scratch))
+		return EFGPathStatus::NoPath;
+
+	return ConstructPath(Scratch.Parent, Goal, OutPath, OutPathLength);
+}
+
+int32 FFGReachableTiles::Find(int32 TileIndex) const
+{
+	const int32 Found = Algo::LowerBound(Tiles, TileIndex);
+	return Found < Tiles.Num() && Tiles[Found] == TileIndex ? Found : INDEX_NONE;
+}
+
+void FFGReachableTiles::GetPathTo(int32 TileIndex, int32 GridWidth, TArray<int32>& OutPath) const
+{
+	OutPath.Reset();
+	for (int32 Entry = Find(TileIndex); Entry != INDEX_NONE; )
+	{
+		OutPath.Add(Tiles[Entry]);
+		if (ArrivalDirs[Entry] == eDir::Nil)
+			break;
+
+		const IVec2 Step = FFGPathGrid::Directions[ArrivalDirs[Entry]];
+		Entry = Find(Tiles[Entry] - Step.y * GridWidth - Step.x);
+	}
+	Algo::Reverse(OutPath);
+}
+
+void FFGPathGrid::StartPathPreview(int32 Start, FFGPathPreview& Preview) const
+{
+	const int32 NumTiles = GetNumTiles();
+	if (Preview.ReachedStamps.Num() != NumTiles || Preview.TreeStamp == MAX_uint32)
+	{
+		Preview.ReachedStamps.Init(0, NumTiles);
+		Preview.SettledStamps.Init(0, NumTiles);
+		Preview.Parent.SetNumUninitialized(NumTiles);
+		Preview.Costs.SetNumUninitialized(NumTiles);
+		Preview.OpenQueue.Reserve(NumTiles);
+		Preview.TreeStamp = 0;
+	}
+
+	++Preview.TreeStamp;
+	Preview.Start = Start;
+	Preview.GridVersion = Version;
+	Preview.NumSettled = 0;
+	Preview.OpenQueue.Reset();
+
+	if (!IsTileIndexValid(Start))
+		return;
+
+	Preview.ReachedStamps[Start] = Preview.TreeStamp;
+	Preview.Parent[Start] = -1;
+	Preview.Costs[Start] = 0;
+	Preview.OpenQueue.PrioritisedAdd(Start, 0);
+}
+
+EFGPathStatus FFGPathGrid::ExtendPathPreview(FFGPathPreview& Preview, int32 Goal, TArrayView<int32> OutPath,
+                                             int32& OutPathLength) const
+{
+	OutPathLength = 0;
+	if (!IsTileIndexValid(Preview.Start) || !IsTileIndexValid(Goal) || Preview.ReachedStamps.Num() != GetNumTiles())
+		return EFGPathStatus::InvalidTiles;
+
+	if (Preview.IsSettled(Goal))
+		return ConstructPath(Preview.Parent, Goal, OutPath, OutPathLength);
+
+	if (IsGoalUnreachable(Preview.Start, Goal) || ObstacleGrid.IsBlocked(Goal))
+		return EFGPathStatus::NoPath;
+
+	const TFGEightNeighborhood<true> Neighborhood{ObstacleGrid, &CostGrid};
+	while (Preview.OpenQueue.Num() > 0)
+	{
+		const int32 Current = Preview.OpenQueue.PopFirst();
+		const int32 CurrentCost = Preview.Costs[Current];
+		Preview.SettledStamps[Current] = Preview.TreeStamp;
+		++Preview.NumSettled;
+
+		Neighborhood.ForEachSuccessor(Current, -1, [&Preview, Current, CurrentCost](int32 Successor, int32 StepCost)
+		{
+			const int32 NewCost = CurrentCost + StepCost;
+			if (Preview.WasReached(Successor) && NewCost >= Preview.Costs[Successor])
+				return;
+
+			Preview.ReachedStamps[Successor] = Preview.TreeStamp;
+			Preview.Costs[Successor] = NewCost;
+			Preview.Parent[Successor] = Current;
+			if (Preview.OpenQueue.Contains(Successor))
+				Preview.OpenQueue.UpdatePriority(Successor, NewCost);
+			else
+				Preview.OpenQueue.PrioritisedAdd(Successor, NewCost);
+		});
+
+		if (Current == Goal)
+			return ConstructPath(Preview.Parent, Goal, OutPath, OutPathLength);
+	}
+
+	return EFGPathStatus::NoPath;
+}
+
+void FFGPathGrid::ComputeReachableTiles(int32 Origin, int32 Budget, FFGRangeScratch& Scratch, FFGReachableTiles& Out) const
+{
+	Out.Origin = Origin;
+	Out.Budget = Budget;
+	Out.GridVersion = Version;
+	Out.Tiles.Reset();
+	Out.Costs.Reset();
+	Out.ArrivalDirs.Reset();
+
+	if (!IsTileIndexValid(Origin) || Budget < 0 || ObstacleGrid.IsBlocked(Origin))
+		return;
+
+	// eDir by (dy + 1) * 3 + dx + 1
+	static const uint8 DirFromOffset[9] = {
+		eDir::Northwest, eDir::North, eDir::Northeast,
+		eDir::West, eDir::Nil, eDir::East,
+		eDir::Southwest, eDir::South, eDir::Southeast
+	};
+
+	Scratch.Prepare(GetNumTiles());
+	Scratch.QueryStamps[Origin] = Scratch.QueryStamp;
+	Scratch.Costs[Origin] = 0;
+	Scratch.ArrivalDirs[Origin] = eDir::Nil;
+	Scratch.OpenQueue.PrioritisedAdd(Origin, 0);
+
+	const TFGEightNeighborhood<true> Neighborhood{ObstacleGrid, &CostGrid};
+	while (Scratch.OpenQueue.Num() > 0)
+	{
+		const int32 Current = Scratch.OpenQueue.PopFirst();
+		const int32 CurrentCost = Scratch.Costs[Current];
+		Scratch.Settled.Add(Current);
+
+		Neighborhood.ForEachSuccessor(Current, -1, [this, &Scratch, Current, CurrentCost, Budget](int32 Successor, int32 StepCost)
+		{
+			const int32 NewCost = CurrentCost + StepCost;
+			if (NewCost > Budget || (Scratch.WasReached(Successor) && NewCost >= Scratch.Costs[Successor]))
+				return;
+
+			const int32 DX = Successor % Width - Current % Width;
+			const int32 DY = Successor / Width - Current / Width;
+			Scratch.QueryStamps[Successor] = Scratch.QueryStamp;
+			Scratch.Costs[Successor] = NewCost;
+			Scratch.ArrivalDirs[Successor] = DirFromOffset[(DY + 1) * 3 + DX + 1];
+			if (Scratch.OpenQueue.Contains(Successor))
+				Scratch.OpenQueue.UpdatePriority(Successor, NewCost);
+			else
+				Scratch.OpenQueue.PrioritisedAdd(Successor, NewCost);
+		});
+	}
+
+	Scratch.Settled.Sort();
+	const int32 NumReached = Scratch.Settled.Num();
+	Out.Tiles.SetNumUninitialized(NumReached);
+	Out.Costs.SetNumUninitialized(NumReached);
+	Out.ArrivalDirs.SetNumUninitialized(NumReached);
+	for (int32 Entry = 0; Entry < NumReached; ++Entry)
+	{
+		const int32 TileIndex = Scratch.Settled[Entry];
+		Out.Tiles[Entry] = TileIndex;
+		Out.Costs[Entry] = Scratch.Costs[TileIndex];
+		Out.ArrivalDirs[Entry] = Scratch.ArrivalDirs[TileIndex];
+	}
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FGGridTypes.h"
+#include "FGObstacleGrid.h"
+#include "FGCostGrid.h"
+#include "FGComponentLabels.h"
+#include "FGClearanceMap.h"
+#include "FGSearchCore.h"
+
+/*
+* Inclusive rectangle of tile coordinates, empty until the first Add.
+*/
+struct FFGTileBounds
+{
+	uint16 MinX = MAX_uint16;
+	uint16 MinY = MAX_uint16;
+	uint16 MaxX = 0;
+	uint16 MaxY = 0;
+
+	void Add(int32 X, int32 Y)
+	{
+		MinX = FMath::Min<uint16>(MinX, X);
+		MinY = FMath::Min<uint16>(MinY, Y);
+		MaxX = FMath::Max<uint16>(MaxX, X);
+		MaxY = FMath::Max<uint16>(MaxY, Y);
+	}
+
+	bool Contains(int32 X, int32 Y) const { return X >= MinX && X <= MaxX && Y >= MinY && Y <= MaxY; }
+};
+
+/*
+* What JPSPreProcess works out per tile: the directions a search has to come from for the tile to be a jump point,
+* and per direction how far the next jump point (positive) or the wall (negative) is.
+*/
+struct FFGJumpTile
+{
+	bool ApproachDirs[4] = { false, false, false, false};
+
+	int32 DirectionValues[8] = {0,0,0,0,0,0,0,0};
+
+	// per direction, every tile some shortest path from here starts out towards. Only filled by BuildGoalBounds
+	FFGTileBounds GoalBounds[8];
+};
+
+using FFGSearchScratch = TFGSearchScratch<int32>;
+
+/*
+* What ComputeReachableTiles found, sorted by tile index so lookups are a binary search. ArrivalDirs is the
+* eDir of the last step onto the tile (Nil for the origin), the parent is one step back against it.
+*/
+struct FGAI_2CORE_API FFGReachableTiles
+{
+	int32 Origin = INDEX_NONE;
+	int32 Budget = 0;
+	uint32 GridVersion = 0;
+
+	TArray<int32> Tiles;
+	TArray<int32> Costs;
+	TArray<uint8> ArrivalDirs;
+
+	int32 Num() const { return Tiles.Num(); }
+
+	// index into the arrays, INDEX_NONE if the tile is out of reach
+	int32 Find(int32 TileIndex) const;
+
+	/*
+	* Origin to TileIndex, both included. Empty if the tile is out of reach.
+	*/
+	void GetPathTo(int32 TileIndex, int32 GridWidth, TArray<int32>& OutPath) const;
+};
+
+/*
+* ComputeReachableTiles' working memory. Tiles remember which query touched them last, so a new query doesn't
+* have to clear anything and only pays for the tiles it reaches.
+*/
+struct FFGRangeScratch
+{
+	TArray<uint32> QueryStamps;
+	TArray<int32> Costs;
+	TArray<uint8> ArrivalDirs;
+	TArray<int32> Settled;
+	PriorityQueue<int32> OpenQueue;
+	uint32 QueryStamp = 0;
+
+	void Prepare(int32 NumTiles)
+	{
+		if (QueryStamps.Num() != NumTiles || QueryStamp == MAX_uint32)
+		{
+			QueryStamps.Init(0, NumTiles);
+			Costs.SetNumUninitialized(NumTiles);
+			ArrivalDirs.SetNumUninitialized(NumTiles);
+			OpenQueue.Reserve(NumTiles);
+			QueryStamp = 0;
+		}
+		++QueryStamp;
+		Settled.Reset();
+		OpenQueue.Reset();
+	}
+
+	bool WasReached(int32 TileIndex) const { return QueryStamps[TileIndex] == QueryStamp; }
+};
+
+/*
+* Dijkstra tree rooted at Start that only grows as far as the goals asked for so far, for path previews
+* where the start stays put and the goal follows the mouse. A goal inside the settled part is a parent walk,
+* one outside it picks the search up where it stopped. Only holds for the grid version it was started on.
+*/
+struct FFGPathPreview
+{
+	int32 Start = INDEX_NONE;
+	uint32 GridVersion = 0;
+
+	// Parent is -1 at the root, same layout ConstructPath walks
+	TArray<int32> Parent;
+	TArray<int32> Costs;
+	// tiles remember which tree touched and settled them last, starting over doesn't clear anything
+	TArray<uint32> ReachedStamps;
+	TArray<uint32> SettledStamps;
+	PriorityQueue<int32> OpenQueue;
+	uint32 TreeStamp = 0;
+	int32 NumSettled = 0;
+
+	bool IsRootedAt(int32 InStart, uint32 InGridVersion) const
+	{
+		return TreeStamp != 0 && Start == InStart && GridVersion == InGridVersion;
+	}
+
+	bool WasReached(int32 TileIndex) const { return ReachedStamps[TileIndex] == TreeStamp; }
+	bool IsSettled(int32 TileIndex) const { return SettledStamps[TileIndex] == TreeStamp; }
+};
+
+/*
+* The grid as the searches see it, without a UObject anywhere near it. AFGGridActor owns one and fills it from
+* the level, headless tools and dedicated server code can build their own from one bool per tile.
+* Every query is const and only touches the scratch it gets handed, so any number of threads can search
+* at once as long as nobody rebuilds in the meantime.
+*/
+class FGAI_2CORE_API FFGPathGrid
+{
+public:
+	// offsets in eDir order, Nil last
+	static const IVec2 Directions[9];
+
+	/*
+	* Packs obstacles and traversal costs (TileCosts may be shorter than the grid, missing tiles cost 1).
+	* Component labels and jump data are left alone, Build does all of it.
+	*/
+	void SetObstacles(int32 InWidth, int32 InHeight, TFunctionRef<bool(int32)> IsTileBlocked, const TArray<uint8>& TileCosts);
+
+	void Build(int32 InWidth, int32 InHeight, TFunctionRef<bool(int32)> IsTileBlocked, const TArray<uint8>& TileCosts);
+
+	void RebuildComponentLabels();
+
+	void RebuildClearance();
+
+	/*
+	* Call after tiles flipped in ObstacleGrid, repairs the component labels and clearance or rebuilds them if it can't.
+	*/
+	void ApplyTileChanges(const TArray<int32>& ChangedTiles);
+
+	/*
+	* Jump distances for JPSRuntime, from the current ObstacleGrid. Just the three passes below in order.
+	*/
+	void JPSPreProcess();
+
+	// drops the jump data (and goal bounds), JPSRuntime says MissingData until the next JPSPreProcess
+	void ClearJumpData();
+
+	/*
+	* The passes on their own, mostly so they can be timed one at a time. FindPrimaryJumpPoints starts
+	* JumpTiles over, the sweeps need its approach directions and the diagonal one the cardinal distances.
+	*/
+	void FindPrimaryJumpPoints();
+	void SweepCardinalJumps();
+	void SweepDiagonalJumps();
+
+	/*
+	* Goal bounding on top of the jump data: one Dijkstra flood per free tile, remembering which first moves
+	* reach every other tile on a shortest path. JPSRuntime then skips every direction whose box doesn't hold
+	* the goal. That's a full search per tile (rows go wide), so it's for maps that don't change while playing.
+	* Needs the jump data first, any of the passes above throws the bounds away again.
+	*/
+	void BuildGoalBounds();
+
+	bool HasGoalBounds() const { return bHasGoalBounds && HasJumpData(); }
+
+	int32 GetNumTiles() const { return Width * Height; }
+
+	bool IsTileIndexValid(int32 TileIndex) const { return TileIndex >= 0 && TileIndex < GetNumTiles(); }
+
+	bool HasJumpData() const { return JumpTiles.Num() == GetNumTiles() && GetNumTiles() > 0; }
+
+	/*
+	* Constant time early out for the searches, so a goal in a walled off area doesn't flood the whole grid first.
+	* Labels that are out of date can't say no. A blocked start is fine, agents can always walk off their tile.
+	*/
+	bool IsGoalUnreachable(int32 Start, int32 Goal) const;
+
+	/*
+	* A* 4-connected with unit costs. Writes the path start->goal into OutPath, OutPathLength is always the
+	* full length, if it is larger than OutPath only the first part was written.
+	*/
+	EFGPathStatus FindPath(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+	                       FFGSearchScratch& Scratch) const;
+
+	/*
+	* Jump point search over the JPSPreProcess data, the path is the jump points only. MissingData without them.
+	*/
+	EFGPathStatus JPSRuntime(int32 Start, int32 Goal, TArrayView<int32> OutPath, int32& OutPathLength,
+	                         FFGSearchScratch& Scratch) const;
+
+	EFGPathStatus ConstructPath(const TArray<int32>& Parent, int32 Goal, TArrayView<int32> OutPath,
+	                            int32& OutPathLength) const;
+
+	/*
+	* FindPath and JPSRuntime for agents covering AgentSize x AgentSize tiles, Start and Goal being their top left tile.
+	* Tiles without enough Clearance count as blocked. The jump data only holds for one tile agents, so the
+	* JPS version jumps on the fly instead. Size 1 just forwards, anything above MaxClearance is MissingData.
+	*/
+	EFGPathStatus FindPathForSize(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+	                              int32& OutPathLength, FFGSearchScratch& Scratch) const;
+	EFGPathStatus JPSRuntimeForSize(int32 Start, int32 Goal, int32 AgentSize, TArrayView<int32> OutPath,
+	                                int32& OutPathLength, FFGSearchScratch& Scratch) const;
+
+	/*
+	* Bounded Dijkstra: every tile Origin can get to for at most Budget, with WeightedAStar's step costs
+	* (10 per cardinal and 14 per diagonal step, times the cost of the tile stepped onto). Blocked origins reach nothing.
+	*/
+	void ComputeReachableTiles(int32 Origin, int32 Budget, FFGRangeScratch& Scratch, FFGReachableTiles& Out) const;
+
+	/*
+	* Starts Preview over from Start on this grid. Same step costs as ComputeReachableTiles, so a preview
+	* and the movement range shown with it agree on what a tile costs.
+	*/
+	void StartPathPreview(int32 Start, FFGPathPreview& Preview) const;
+
+	/*
+	* Cheapest path from the preview's start to Goal, settling only as many more tiles as it takes to reach it.
+	* Output works like FindPath's. Goals the component labels rule out don't grow the tree at all.
+	*/
+	EFGPathStatus ExtendPathPreview(FFGPathPreview& Preview, int32 Goal, TArrayView<int32> OutPath,
+	                                int32& OutPathLength) const;
+
+	int32 Width = 0;
+	int32 Height = 0;
+
+	FFGObstacleGrid ObstacleGrid;
+
+	/*
+	* Traversal costs plus the uniform patch flags, rebuilt together with ObstacleGrid.
+	*/
+	FFGCostGrid CostGrid;
+
+	FFGComponentLabels ComponentLabels4;
+	FFGComponentLabels ComponentLabels8;
+
+	FFGClearanceMap Clearance;
+
+	TArray<FFGJumpTile> JumpTiles;
+
+	// bumped by everything that writes JumpTiles, so a copy of the grid can tell whether its jump data is still current
+	uint32 JumpRevision = 0;
+
+	bool bHasGoalBounds = false;
+
+	// bumped by whoever publishes a new copy of the grid, see AFGGridActor::AcquirePathGridSnapshot
+	uint32 Version = 0;
+};
+
+/*
+* A published grid nobody edits anymore, shared between the queries reading it.
+*/
+using FFGPathGridSnapshot = TSharedPtr<const FFGPathGrid, ESPMode::ThreadSafe>;
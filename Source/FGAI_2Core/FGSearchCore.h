@@ -0,0 +1,208 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PriorityQueue.h"
+#include "FGObstacleGrid.h"
+#include "FGCostGrid.h"
+
+/*
+* One A* loop for all the single-source grid searches. What differs between them is plugged in at compile time:
+*  - Neighborhood: ForEachSuccessor(Tile, ParentTile, Visit) calls Visit(Successor, StepCost) for every way out of Tile
+*  - Heuristic: operator()(Tile) estimates the cost from Tile to the goal
+*  - CostType: what G scores and open list priorities are kept in
+*  - OpenListType: anything with PriorityQueue's interface, keyed on tile index
+* The neighborhoods below read obstacles through ObstacleType, anything with Width and IsBlocked(X, Y) that
+* treats tiles outside the grid as blocked (FFGObstacleGrid, or FFGClearanceView for bigger agents).
+* Everything gets inlined into the loop, so a 4-connected unit cost search doesn't pay for what the jump
+* or weighted ones need. Tiles are plain indices (Y * Width + X) all the way through.
+*/
+
+template <typename CostType = int32, typename OpenListType = PriorityQueue<int32, CostType>>
+struct TFGSearchScratch
+{
+	// TNumericLimits<CostType>::Max() for tiles the search hasn't reached
+	TArray<CostType> GScores;
+	TArray<int32> Parent;
+	OpenListType OpenQueue;
+
+	void Prepare(int32 NumTiles)
+	{
+		//Init on a warm array of the same size reuses the allocation
+		GScores.Init(TNumericLimits<CostType>::Max(), NumTiles);
+		Parent.Init(-1, NumTiles);
+		OpenQueue.Reset();
+		OpenQueue.Reserve(NumTiles);
+	}
+
+	bool WasReached(int32 TileIndex) const { return GScores[TileIndex] != TNumericLimits<CostType>::Max(); }
+};
+
+/*
+* Runs until Goal gets popped (true, the path is in Scratch.Parent) or the open list runs dry (false).
+* Pass INDEX_NONE as Goal to flood everything reachable, Dijkstra style with FFGZeroHeuristic.
+* Scratch has to be prepared for the grid size beforehand.
+*/
+template <typename NeighborhoodType, typename HeuristicType, typename CostType, typename OpenListType>
+bool RunGridSearch(const NeighborhoodType& Neighborhood, const HeuristicType& Heuristic, int32 Start, int32 Goal,
+                   TFGSearchScratch<CostType, OpenListType>& Scratch)
+{
+	OpenListType& OpenQueue = Scratch.OpenQueue;
+	Scratch.GScores[Start] = CostType(0);
+	OpenQueue.PrioritisedAdd(Start, Heuristic(Start));
+
+	while (OpenQueue.Num() > 0)
+	{
+		const int32 CurrentTileIdx = OpenQueue.PopFirst();
+		if (CurrentTileIdx == Goal)
+			return true;
+
+		const CostType CurrentGScore = Scratch.GScores[CurrentTileIdx];
+		Neighborhood.ForEachSuccessor(CurrentTileIdx, Scratch.Parent[CurrentTileIdx],
+			[&Scratch, &OpenQueue, &Heuristic, CurrentTileIdx, CurrentGScore](int32 Successor, CostType StepCost)
+			{
+				const CostType NewGScore = CurrentGScore + StepCost;
+				if (!(NewGScore < Scratch.GScores[Successor]))
+					return;
+
+				Scratch.Parent[Successor] = CurrentTileIdx;
+				Scratch.GScores[Successor] = NewGScore;
+
+				const CostType FScore = NewGScore + Heuristic(Successor);
+				if (OpenQueue.Contains(Successor))
+					OpenQueue.UpdatePriority(Successor, FScore);
+				else
+					OpenQueue.PrioritisedAdd(Successor, FScore);
+			});
+	}
+	return false;
+}
+
+/*
+* Cardinal steps only, each costs StepCost.
+*/
+template <typename CostType = int32, typename ObstacleType = FFGObstacleGrid>
+struct TFGFourNeighborhood
+{
+	const ObstacleType& Obstacles;
+	CostType StepCost = CostType(1);
+
+	template <typename VisitType>
+	FORCEINLINE void ForEachSuccessor(int32 TileIndex, int32 /*ParentTile*/, VisitType&& Visit) const
+	{
+		const int32 Width = Obstacles.Width;
+		const int32 X = TileIndex % Width;
+		const int32 Y = TileIndex / Width;
+
+		// same order as eDir
+		if (!Obstacles.IsBlocked(X, Y - 1))
+			Visit(TileIndex - Width, StepCost);
+		if (!Obstacles.IsBlocked(X, Y + 1))
+			Visit(TileIndex + Width, StepCost);
+		if (!Obstacles.IsBlocked(X - 1, Y))
+			Visit(TileIndex - 1, StepCost);
+		if (!Obstacles.IsBlocked(X + 1, Y))
+			Visit(TileIndex + 1, StepCost);
+	}
+};
+
+/*
+* All eight directions, diagonals only where both cardinal tiles beside them are free.
+* bWeighted multiplies every step by the cost of the tile it lands on, CostGrid can be null otherwise.
+*/
+template <bool bWeighted, typename CostType = int32, typename ObstacleType = FFGObstacleGrid>
+struct TFGEightNeighborhood
+{
+	const ObstacleType& Obstacles;
+	const FFGCostGrid* CostGrid = nullptr;
+	CostType CardinalCost = CostType(10);
+	CostType DiagonalCost = CostType(14);
+
+	template <typename VisitType>
+	FORCEINLINE void ForEachSuccessor(int32 TileIndex, int32 /*ParentTile*/, VisitType&& Visit) const
+	{
+		static constexpr int32 OffsetX[8] = {0, 0, -1, 1, -1, 1, -1, 1};
+		static constexpr int32 OffsetY[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+
+		const int32 Width = Obstacles.Width;
+		const int32 X = TileIndex % Width;
+		const int32 Y = TileIndex / Width;
+
+		for (int32 i = 0; i < 8; ++i)
+		{
+			const int32 DX = OffsetX[i];
+			const int32 DY = OffsetY[i];
+			if (Obstacles.IsBlocked(X + DX, Y + DY))
+				continue;
+
+			const bool bDiagonal = i >= 4;
+			if (bDiagonal && (Obstacles.IsBlocked(X + DX, Y) || Obstacles.IsBlocked(X, Y + DY)))
+				continue;
+
+			const int32 NeighborIdx = TileIndex + DY * Width + DX;
+			const CostType StepCost = bDiagonal ? DiagonalCost : CardinalCost;
+			Visit(NeighborIdx, bWeighted ? StepCost * CostGrid->GetCost(NeighborIdx) : StepCost);
+		}
+	}
+};
+
+/*
+* Any other neighborhood with an extra cost on top of every step, Hook(Successor, StepCost) returns it.
+* That is how queries steer around things the grid doesn't know about, like threat from an influence layer.
+* The extra cost must never be negative, or the heuristics stop being admissible.
+*/
+template <typename InnerType, typename HookType>
+struct TFGCostHookNeighborhood
+{
+	const InnerType& Inner;
+	const HookType& Hook;
+
+	template <typename VisitType>
+	FORCEINLINE void ForEachSuccessor(int32 TileIndex, int32 ParentTile, VisitType&& Visit) const
+	{
+		Inner.ForEachSuccessor(TileIndex, ParentTile, [this, &Visit](int32 Successor, auto StepCost)
+		{
+			Visit(Successor, StepCost + Hook(Successor, StepCost));
+		});
+	}
+};
+
+struct FFGZeroHeuristic
+{
+	FORCEINLINE int32 operator()(int32 /*TileIndex*/) const { return 0; }
+};
+
+template <typename CostType = int32>
+struct TFGManhattanHeuristic
+{
+	int32 Width;
+	int32 GoalX;
+	int32 GoalY;
+	CostType Scale = CostType(1);
+
+	FORCEINLINE CostType operator()(int32 TileIndex) const
+	{
+		return Scale * (FMath::Abs(TileIndex % Width - GoalX) + FMath::Abs(TileIndex / Width - GoalY));
+	}
+};
+
+/*
+* Exact 8-connected distance on an empty grid, Scale lets weighted searches multiply in their cheapest tile.
+*/
+template <typename CostType = int32>
+struct TFGOctileHeuristic
+{
+	int32 Width;
+	int32 GoalX;
+	int32 GoalY;
+	CostType CardinalCost = CostType(10);
+	CostType DiagonalCost = CostType(14);
+	CostType Scale = CostType(1);
+
+	FORCEINLINE CostType operator()(int32 TileIndex) const
+	{
+		const int32 XDiff = FMath::Abs(TileIndex % Width - GoalX);
+		const int32 YDiff = FMath::Abs(TileIndex / Width - GoalY);
+		const int32 Straight = FMath::Abs(XDiff - YDiff);
+		return Scale * (CardinalCost * Straight + DiagonalCost * FMath::Min(XDiff, YDiff));
+	}
+};
@@ -0,0 +1,158 @@
+#include "FGVisibility.h"
+
+#include "Async/ParallelFor.h"
+#include "FGObstacleGrid.h"
+
+namespace
+{
+	/*
+	* Slopes are kept as exact fractions, Den is always positive. Floats would let tiles right on the edge
+	* of a shadow flicker between visible and not depending on the direction they're looked at from.
+	*/
+	struct FSlope
+	{
+		int32 Num;
+		int32 Den;
+	};
+
+	// floor(A / B) for positive B
+	FORCEINLINE int32 FloorDiv(int32 A, int32 B)
+	{
+		return A >= 0 ? A / B : -((-A + B - 1) / B);
+	}
+
+	struct FScanRow
+	{
+		int32 Depth;
+		FSlope Start;
+		FSlope End;
+
+		// round(Depth * Start) with ties going up, round(Depth * End) with ties going down
+		int32 MinCol() const { return FloorDiv(2 * Depth * Start.Num + Start.Den, 2 * Start.Den); }
+		int32 MaxCol() const { return -FloorDiv(-(2 * Depth * End.Num - End.Den), 2 * End.Den); }
+
+		// the tile's center lies within the row's slopes
+		bool IsSymmetric(int32 Col) const
+		{
+			return Col * Start.Den >= Depth * Start.Num && Col * End.Den <= Depth * End.Num;
+		}
+	};
+
+	// slope through the tile's edge closest to the start of the row
+	FORCEINLINE FSlope EdgeSlope(int32 Depth, int32 Col)
+	{
+		return {2 * Col - 1, 2 * Depth};
+	}
+}
+
+void FFGVisibility::ComputeFieldOfView(const FFGObstacleGrid& Obstacles, int32 Origin, int32 Radius,
+                                       TArray<int32>& OutVisibleTiles)
+{
+	OutVisibleTiles.Reset();
+
+	const int32 Width = Obstacles.Width;
+	if (Width <= 0 || Origin < 0 || Origin >= Width * Obstacles.Height)
+		return;
+
+	const int32 OriginX = Origin % Width;
+	const int32 OriginY = Origin / Width;
+	const int32 MaxDepth = Radius < 0 ? FMath::Max(Width, Obstacles.Height) : Radius;
+	const int32 RadiusSquared = Radius < 0 ? MAX_int32 : Radius * Radius;
+
+	OutVisibleTiles.Add(Origin);
+
+	// each quadrant maps (depth, column) to a grid tile: north, south, east, west
+	static const int32 DepthX[4] = {0, 0, 1, -1};
+	static const int32 DepthY[4] = {-1, 1, 0, 0};
+	static const int32 ColX[4] = {1, 1, 0, 0};
+	static const int32 ColY[4] = {0, 0, 1, 1};
+
+	TArray<FScanRow, TInlineAllocator<64>> Rows;
+	for (int32 Quadrant = 0; Quadrant < 4; ++Quadrant)
+	{
+		auto TileX = [&](int32 Depth, int32 Col) { return OriginX + DepthX[Quadrant] * Depth + ColX[Quadrant] * Col; };
+		auto TileY = [&](int32 Depth, int32 Col) { return OriginY + DepthY[Quadrant] * Depth + ColY[Quadrant] * Col; };
+
+		Rows.Reset();
+		Rows.Add({1, {-1, 1}, {1, 1}});
+		while (Rows.Num() > 0)
+		{
+			FScanRow Row = Rows.Pop(false);
+			if (Row.Depth > MaxDepth)
+				continue;
+
+			// 0 before the first tile, then 1 for a wall and 2 for a floor
+			int32 Previous = 0;
+			for (int32 Col = Row.MinCol(), MaxCol = Row.MaxCol(); Col <= MaxCol; ++Col)
+			{
+				const int32 X = TileX(Row.Depth, Col);
+				const int32 Y = TileY(Row.Depth, Col);
+				const bool bWall = Obstacles.IsBlocked(X, Y);
+
+				if ((bWall || Row.IsSymmetric(Col)) && Obstacles.IsInside(X, Y)
+					&& Row.Depth * Row.Depth + Col * Col <= RadiusSquared)
+				{
+					OutVisibleTiles.Add(Y * Width + X);
+				}
+
+				if (Previous == 1 && !bWall)
+					Row.Start = EdgeSlope(Row.Depth, Col);
+
+				// the floor run so far casts on into the next row, up to the edge of this wall
+				if (Previous == 2 && bWall)
+					Rows.Add({Row.Depth + 1, Row.Start, EdgeSlope(Row.Depth, Col)});
+
+				Previous = bWall ? 1 : 2;
+			}
+
+			if (Previous == 2)
+				Rows.Add({Row.Depth + 1, Row.Start, Row.End});
+		}
+	}
+
+	// the quadrants share their diagonals
+	OutVisibleTiles.Sort();
+	int32 NumUnique = 0;
+	for (int32 Index = 0; Index < OutVisibleTiles.Num(); ++Index)
+	{
+		if (NumUnique == 0 || OutVisibleTiles[NumUnique - 1] != OutVisibleTiles[Index])
+			OutVisibleTiles[NumUnique++] = OutVisibleTiles[Index];
+	}
+	OutVisibleTiles.SetNum(NumUnique, false);
+}
+
+void FFGVisibility::ComputeFieldOfViewBatch(const FFGObstacleGrid& Obstacles, TArrayView<const int32> Origins,
+                                            int32 Radius, TArray<TArray<int32>>& OutVisibleTiles)
+{
+	OutVisibleTiles.SetNum(Origins.Num());
+	ParallelFor(Origins.Num(), [&Obstacles, &Origins, Radius, &OutVisibleTiles](int32 Index)
+	{
+		ComputeFieldOfView(Obstacles, Origins[Index], Radius, OutVisibleTiles[Index]);
+	});
+}
+
+void FFGVisibility::HasLineOfSightBatch(const FFGObstacleGrid& Obstacles, TArrayView<const FFGTilePair> Pairs,
+                                        TArrayView<bool> OutResults)
+{
+	check(OutResults.Num() >= Pairs.Num());
+
+	const int32 Width = Obstacles.Width;
+	const int32 NumTiles = Width * Obstacles.Height;
+
+	// a single check is far too little work for a task of its own
+	constexpr int32 PairsPerBatch = 64;
+	const int32 NumPairs = Pairs.Num();
+	ParallelFor(FMath::DivideAndRoundUp(NumPairs, PairsPerBatch), [&, Width, NumTiles, NumPairs](int32 Batch)
+	{
+		for (int32 Index = Batch * PairsPerBatch, Last = FMath::Min(Index + PairsPerBatch, NumPairs); Index < Last; ++Index)
+		{
+			const FFGTilePair& Pair = Pairs[Index];
+			if (Pair.From < 0 || Pair.From >= NumTiles || Pair.To < 0 || Pair.To >= NumTiles)
+			{
+				OutResults[Index] = false;
+				continue;
+			}
+			OutResults[Index] = Obstacles.HasLineOfSight(Pair.From % Width, Pair.From / Width, Pair.To % Width, Pair.To / Width);
+		}
+	});
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFGObstacleGrid;
+
+/*
+* Two tile indices for the batched line of sight checks.
+*/
+struct FFGTilePair
+{
+	int32 From = INDEX_NONE;
+	int32 To = INDEX_NONE;
+};
+
+/*
+* Visibility straight off the bit-packed obstacles, no physics involved. Everything here only reads the grid,
+* so any thread can run it on a grid nobody edits meanwhile (a FFGPathGridSnapshot's ObstacleGrid).
+*/
+struct FGAI_2CORE_API FFGVisibility
+{
+	/*
+	* Symmetric shadowcasting: every tile the origin sees sees the origin back, walls that face the origin
+	* are visible themselves. Radius is in tiles, measured from tile center to tile center, anything negative
+	* means no limit. OutVisibleTiles is sorted and includes the origin.
+	*/
+	static void ComputeFieldOfView(const FFGObstacleGrid& Obstacles, int32 Origin, int32 Radius,
+	                               TArray<int32>& OutVisibleTiles);
+
+	/*
+	* One field of view per origin, origins spread over the task graph workers.
+	*/
+	static void ComputeFieldOfViewBatch(const FFGObstacleGrid& Obstacles, TArrayView<const int32> Origins,
+	                                    int32 Radius, TArray<TArray<int32>>& OutVisibleTiles);
+
+	/*
+	* FFGObstacleGrid::HasLineOfSight for every pair, in parallel batches. OutResults needs as many elements as Pairs,
+	* pairs with a tile outside the grid get false.
+	*/
+	static void HasLineOfSightBatch(const FFGObstacleGrid& Obstacles, TArrayView<const FFGTilePair> Pairs,
+	                                TArrayView<bool> OutResults);
+};
@@ -0,0 +1,156 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Binary min-heap keyed on PriorityType (int32 unless a search keeps float costs), values are tile indices
+* so they double as the index into Positions.
+* Equal priorities pop newest first, same order the old sorted-list version gave us.
+* Reset keeps every allocation around, a warm queue doesn't touch the heap allocator.
+*/
+template <typename T = int32, typename PriorityType = int32>
+class PriorityQueue
+{
+public:
+	struct ValuePriority
+	{
+		PriorityType prio;
+		T value;
+		uint32 order;
+	};
+
+	PriorityQueue()
+	{
+	}
+
+	void Reserve(int32 NumValues)
+	{
+		Heap.Reserve(NumValues);
+		PadPositions(NumValues);
+	}
+
+	void PrioritisedAdd(const T& Value, const PriorityType& Prio)
+	{
+		PadPositions(Value + 1);
+
+		const int32 Index = Heap.Add(ValuePriority{Prio, Value, NextOrder++});
+		Positions[Value] = Index;
+		SiftUp(Index);
+	};
+
+	//moves the value to its new place if the prio changed, does nothing if it isn't queued.
+	void UpdatePriority(const T& Value, const PriorityType& Prio)
+	{
+		if (!Contains(Value))
+			return;
+
+		const int32 Index = Positions[Value];
+		if (Heap[Index].prio == Prio)
+			return;
+
+		const bool bDecreased = Prio < Heap[Index].prio;
+		Heap[Index].prio = Prio;
+		Heap[Index].order = NextOrder++;
+		if (bDecreased)
+			SiftUp(Index);
+		else
+			SiftDown(Index);
+	}
+
+	T PopFirst()
+	{
+		const T Result = Heap[0].value;
+		Positions[Result] = INDEX_NONE;
+
+		const ValuePriority Last = Heap.Pop(false);
+		if (Heap.Num() > 0)
+		{
+			Heap[0] = Last;
+			Positions[Last.value] = 0;
+			SiftDown(0);
+		}
+		return Result;
+	};
+
+	bool Contains(const T& Value) const
+	{
+		return Positions.IsValidIndex(Value) && Positions[Value] != INDEX_NONE;
+	};
+
+	int32 Num() const
+	{
+		return Heap.Num();
+	}
+
+	PriorityType TopPriority() const
+	{
+		return Heap[0].prio;
+	}
+
+	void Reset()
+	{
+		for (const ValuePriority& Entry : Heap)
+		{
+			Positions[Entry.value] = INDEX_NONE;
+		}
+		Heap.Reset();
+		NextOrder = 0;
+	}
+
+private:
+	static bool Before(const ValuePriority& A, const ValuePriority& B)
+	{
+		return A.prio < B.prio || (A.prio == B.prio && A.order > B.order);
+	}
+
+	void PadPositions(int32 NewNum)
+	{
+		for (int32 Index = Positions.Num(); Index < NewNum; ++Index)
+		{
+			Positions.Add(INDEX_NONE);
+		}
+	}
+
+	void Place(int32 Index, const ValuePriority& Entry)
+	{
+		Heap[Index] = Entry;
+		Positions[Entry.value] = Index;
+	}
+
+	void SiftUp(int32 Index)
+	{
+		const ValuePriority Entry = Heap[Index];
+		while (Index > 0)
+		{
+			const int32 ParentIndex = (Index - 1) / 2;
+			if (!Before(Entry, Heap[ParentIndex]))
+				break;
+			Place(Index, Heap[ParentIndex]);
+			Index = ParentIndex;
+		}
+		Place(Index, Entry);
+	}
+
+	void SiftDown(int32 Index)
+	{
+		const ValuePriority Entry = Heap[Index];
+		const int32 Count = Heap.Num();
+		while (true)
+		{
+			int32 Child = Index * 2 + 1;
+			if (Child >= Count)
+				break;
+			if (Child + 1 < Count && Before(Heap[Child + 1], Heap[Child]))
+				++Child;
+			if (!Before(Heap[Child], Entry))
+				break;
+			Place(Index, Heap[Child]);
+			Index = Child;
+		}
+		Place(Index, Entry);
+	}
+
+	TArray<ValuePriority> Heap;
+	TArray<int32> Positions;
+	uint32 NextOrder = 0;
+};
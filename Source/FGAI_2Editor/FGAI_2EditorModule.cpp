@@ -1,11 +1,15 @@
 #include "FGAI_2EditorModule.h"
+#include "EditorModeRegistry.h"
+#include "FGGridPaintEdMode.h"
+#include "Textures/SlateIcon.h"
 
 void FFGAI_2EditorModule::StartupModule()
 {
-
+	FEditorModeRegistry::Get().RegisterMode<FFGGridPaintEdMode>(FFGGridPaintEdMode::EM_GridPaint,
+		NSLOCTEXT("FGAI_2Editor", "GridPaintMode", "Grid Paint"), FSlateIcon(), true);
 }
 
 void FFGAI_2EditorModule::ShutdownModule()
 {
-
+	FEditorModeRegistry::Get().UnregisterMode(FFGGridPaintEdMode::EM_GridPaint);
 }
@@ -1,16 +1,58 @@
 #include "FGGridBlockVisualizer.h"
 #include "FGAI_2/Grid/FGGridBlockComponent.h"
-#include "DrawDebugHelpers.h"
+#include "GameFramework/Actor.h"
+#include "SceneManagement.h"
+#include "SceneView.h"
 
 void FFGGridBlockVisualizer::DrawVisualization(const UActorComponent* Component, const FSceneView* View, FPrimitiveDrawInterface* PDI)
 {
 	const UFGGridBlockComponent* GridBlockComponent = Cast<UFGGridBlockComponent>(Component);
+	if (GridBlockComponent == nullptr || GridBlockComponent->GetOwner() == nullptr)
+		return;
 
-	if (GridBlockComponent != nullptr && GridBlockComponent->GetOwner() != nullptr)
+	if (View != LastView || View->Family->FrameNumber != LastFrameNumber)
 	{
-		const FMatrix Matrix = GridBlockComponent->GetBlockTransform().ToMatrixNoScale();
-		const FVector ExtentsHalf = GridBlockComponent->Extents * 0.5f;
-		const FBox Box(-ExtentsHalf, ExtentsHalf);
-		::DrawWireBox(PDI, Matrix, Box, FLinearColor::Green, 0);
+		LastView = View;
+		LastFrameNumber = View->Family->FrameNumber;
+		DrawnOwners.Reset();
+	}
+
+	const AActor* Owner = GridBlockComponent->GetOwner();
+	bool bAlreadyDrawn = false;
+	DrawnOwners.Add(Owner, &bAlreadyDrawn);
+	if (bAlreadyDrawn)
+		return;
+
+	// a selected actor shows all of its blocks, otherwise only the blocks picked in the component list
+	const bool bOwnerSelected = Owner->IsSelected();
+	const TInlineComponentArray<UFGGridBlockComponent*> Blocks(Owner);
+
+	PDI->AddReserveLines(SDPG_World, Blocks.Num() * 12);
+	for (const UFGGridBlockComponent* Block : Blocks)
+	{
+		if (!bOwnerSelected && !Block->IsSelectedInEditor())
+			continue;
+
+		const FTransform BlockTransform = Block->GetBlockTransform();
+		const FVector ExtentsHalf = Block->Extents * 0.5f;
+
+		FVector Corners[8];
+		for (int32 Corner = 0; Corner < 8; ++Corner)
+		{
+			const FVector Local((Corner & 1) ? ExtentsHalf.X : -ExtentsHalf.X,
+			                    (Corner & 2) ? ExtentsHalf.Y : -ExtentsHalf.Y,
+			                    (Corner & 4) ? ExtentsHalf.Z : -ExtentsHalf.Z);
+			Corners[Corner] = BlockTransform.TransformPositionNoScale(Local);
+		}
+
+		// the 12 edges join the corners that differ in one axis
+		for (int32 Corner = 0; Corner < 8; ++Corner)
+		{
+			for (int32 Axis = 1; Axis < 8; Axis <<= 1)
+			{
+				if ((Corner & Axis) == 0)
+					PDI->DrawLine(Corners[Corner], Corners[Corner | Axis], FLinearColor::Green, SDPG_World);
+			}
+		}
 	}
 }
@@ -2,10 +2,20 @@
 
 #include "ComponentVisualizer.h"
 
+class AActor;
 class UActorComponent;
 
+/*
+* Wire boxes for block components. The editor calls us once per component, so the first call for an actor
+* in a view draws all of its selected blocks as one batch of lines and the calls for its other blocks do nothing.
+*/
 class FFGGridBlockVisualizer : public FComponentVisualizer
 {
 	/** Draw visualization for the supplied component */
 	virtual void DrawVisualization(const UActorComponent* Component, const FSceneView* View, FPrimitiveDrawInterface* PDI) override;
+
+	// actors already drawn into LastView this frame
+	const FSceneView* LastView = nullptr;
+	uint32 LastFrameNumber = 0;
+	TSet<const AActor*> DrawnOwners;
 };
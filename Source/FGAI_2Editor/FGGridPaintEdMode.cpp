@@ -0,0 +1,259 @@
+#include "FGGridPaintEdMode.h"
+
+#include "CanvasItem.h"
+#include "CanvasTypes.h"
+#include "DynamicMeshBuilder.h"
+#include "Editor.h"
+#include "EditorModeManager.h"
+#include "EditorViewportClient.h"
+#include "Engine/Selection.h"
+#include "EngineUtils.h"
+#include "SceneManagement.h"
+#include "SceneView.h"
+#include "FGAI_2/Grid/FGGridActor.h"
+
+#define LOCTEXT_NAMESPACE "FGGridPaintEdMode"
+
+const FEditorModeID FFGGridPaintEdMode::EM_GridPaint = TEXT("EM_FGGridPaint");
+
+void FFGGridPaintEdMode::Enter()
+{
+	FEdMode::Enter();
+
+	Grid = FindGrid();
+}
+
+void FFGGridPaintEdMode::Exit()
+{
+	EndStroke();
+	Grid.Reset();
+
+	FEdMode::Exit();
+}
+
+AFGGridActor* FFGGridPaintEdMode::FindGrid() const
+{
+	if (AFGGridActor* Selected = GEditor->GetSelectedActors()->GetTop<AFGGridActor>())
+		return Selected;
+
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+		return nullptr;
+
+	TActorIterator<AFGGridActor> It(World);
+	return It ? *It : nullptr;
+}
+
+bool FFGGridPaintEdMode::InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event)
+{
+	if (Key == EKeys::LeftMouseButton)
+	{
+		if (Event == IE_Pressed && bHasHover && !Viewport->KeyState(EKeys::LeftAlt) && !Viewport->KeyState(EKeys::RightAlt))
+		{
+			bErasing = Viewport->KeyState(EKeys::LeftShift) || Viewport->KeyState(EKeys::RightShift);
+			BeginStroke();
+			PaintToHover();
+			return true;
+		}
+		if (Event == IE_Released && bPainting)
+		{
+			EndStroke();
+			return true;
+		}
+	}
+
+	// between strokes shift only switches the brush, a running stroke keeps what it started as
+	if ((Key == EKeys::LeftShift || Key == EKeys::RightShift) && !bPainting && Event != IE_Repeat)
+		bErasing = Event == IE_Pressed;
+
+	if (Event == IE_Pressed && (Key == EKeys::LeftBracket || Key == EKeys::RightBracket))
+	{
+		BrushRadius = FMath::Clamp(BrushRadius + (Key == EKeys::RightBracket ? 1 : -1), 0, 64);
+		return true;
+	}
+
+	return FEdMode::InputKey(ViewportClient, Viewport, Key, Event);
+}
+
+bool FFGGridPaintEdMode::InputDelta(FEditorViewportClient* InViewportClient, FViewport* InViewport, FVector& InDrag, FRotator& InRot, FVector& InScale)
+{
+	// dragging paints, it doesn't move the camera
+	return bPainting;
+}
+
+bool FFGGridPaintEdMode::MouseMove(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 X, int32 Y)
+{
+	UpdateHover(ViewportClient, Viewport, X, Y);
+	return false;
+}
+
+bool FFGGridPaintEdMode::CapturedMouseMove(FEditorViewportClient* InViewportClient, FViewport* InViewport, int32 InMouseX, int32 InMouseY)
+{
+	if (UpdateHover(InViewportClient, InViewport, InMouseX, InMouseY) && bPainting)
+		PaintToHover();
+
+	return bPainting;
+}
+
+bool FFGGridPaintEdMode::UpdateHover(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 MouseX, int32 MouseY)
+{
+	bHasHover = false;
+
+	if (!Grid.IsValid())
+		Grid = FindGrid();
+
+	AFGGridActor* GridActor = Grid.Get();
+	if (GridActor == nullptr)
+		return false;
+
+	FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(Viewport, ViewportClient->GetScene(), ViewportClient->EngineShowFlags)
+		.SetRealtimeUpdate(ViewportClient->IsRealtime()));
+	FSceneView* View = ViewportClient->CalcSceneView(&ViewFamily);
+	const FViewportCursorLocation Cursor(View, ViewportClient, MouseX, MouseY);
+
+	const FVector PlaneUp = GridActor->GetActorUpVector();
+	const float Facing = FVector::DotProduct(PlaneUp, Cursor.GetDirection());
+	if (FMath::IsNearlyZero(Facing))
+		return false;
+
+	const FPlane GridPlane(GridActor->GetActorLocation(), PlaneUp);
+	const FVector Location = FMath::RayPlaneIntersection(Cursor.GetOrigin(), Cursor.GetDirection(), GridPlane);
+
+	int32 TileX = 0;
+	int32 TileY = 0;
+	if (!GridActor->GetXYFromWorldLocation(Location, TileX, TileY))
+		return false;
+
+	bHasHover = true;
+	HoverTile = FIntPoint(TileX, TileY);
+	HoverLocation = GridActor->GetWorldLocationFromXY(TileX, TileY);
+	return true;
+}
+
+void FFGGridPaintEdMode::BeginStroke()
+{
+	AFGGridActor* GridActor = Grid.Get();
+	if (GridActor == nullptr || bPainting)
+		return;
+
+	GEditor->BeginTransaction(bErasing ? LOCTEXT("EraseTiles", "Erase Grid Tiles") : LOCTEXT("PaintTiles", "Paint Grid Tiles"));
+	GridActor->Modify();
+
+	bPainting = true;
+	LastDabTile = HoverTile;
+	StrokeTiles.Reset();
+}
+
+void FFGGridPaintEdMode::EndStroke()
+{
+	if (!bPainting)
+		return;
+
+	bPainting = false;
+	StrokeTiles.Reset();
+
+	if (AFGGridActor* GridActor = Grid.Get())
+		GridActor->FinishTileEdits();
+
+	GEditor->EndTransaction();
+}
+
+void FFGGridPaintEdMode::PaintToHover()
+{
+	AFGGridActor* GridActor = Grid.Get();
+	if (GridActor == nullptr || !bHasHover)
+		return;
+
+	BrushTiles.Reset();
+	const FIntPoint Delta = HoverTile - LastDabTile;
+	const int32 NumSteps = FMath::Max(FMath::Abs(Delta.X), FMath::Abs(Delta.Y));
+	for (int32 Step = 0; Step <= NumSteps; ++Step)
+	{
+		const float Alpha = NumSteps > 0 ? static_cast<float>(Step) / NumSteps : 1.0f;
+		const int32 CenterX = LastDabTile.X + FMath::RoundToInt(Delta.X * Alpha);
+		const int32 CenterY = LastDabTile.Y + FMath::RoundToInt(Delta.Y * Alpha);
+
+		for (int32 OffsetY = -BrushRadius; OffsetY <= BrushRadius; ++OffsetY)
+		{
+			for (int32 OffsetX = -BrushRadius; OffsetX <= BrushRadius; ++OffsetX)
+			{
+				int32 TileIndex;
+				if (OffsetX * OffsetX + OffsetY * OffsetY <= BrushRadius * BrushRadius
+					&& GridActor->GetTileIndexFromXY(CenterX + OffsetX, CenterY + OffsetY, TileIndex))
+				{
+					BrushTiles.Add(TileIndex);
+				}
+			}
+		}
+	}
+	LastDabTile = HoverTile;
+
+	// one grid update for the whole move, however many dabs it took
+	ChangedTiles.Reset();
+	GridActor->PaintImportedTiles(BrushTiles, !bErasing, ChangedTiles);
+	StrokeTiles.Append(ChangedTiles);
+}
+
+void FFGGridPaintEdMode::Render(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI)
+{
+	FEdMode::Render(View, Viewport, PDI);
+
+	const AFGGridActor* GridActor = Grid.Get();
+	if (GridActor == nullptr)
+		return;
+
+	const FVector AxisX = GridActor->GetActorForwardVector();
+	const FVector AxisY = GridActor->GetActorRightVector();
+	const FVector Up = GridActor->GetActorUpVector();
+
+	// the stroke so far, the block mesh only catches up when it ends
+	if (StrokeTiles.Num() > 0)
+	{
+		const float HalfTile = GridActor->GetTileSizeHalf();
+		const FVector Lift = Up * 2.0f;
+		const FColor BlockedColor(220, 40, 40);
+		const FColor ClearedColor(40, 200, 80);
+
+		FDynamicMeshBuilder MeshBuilder(View->GetFeatureLevel());
+		for (const int32 TileIndex : StrokeTiles)
+		{
+			int32 TileX;
+			int32 TileY;
+			if (!GridActor->GetXYFromTileIndex(TileX, TileY, TileIndex))
+				continue;
+
+			const FVector Center = GridActor->GetWorldLocationFromXY(TileX, TileY) + Lift;
+			const FColor Color = GridActor->TileList[TileIndex].bBlock ? BlockedColor : ClearedColor;
+			const int32 First = MeshBuilder.AddVertex(FDynamicMeshVertex(Center - AxisX * HalfTile - AxisY * HalfTile, FVector2D(0, 0), Color));
+			MeshBuilder.AddVertex(FDynamicMeshVertex(Center + AxisX * HalfTile - AxisY * HalfTile, FVector2D(1, 0), Color));
+			MeshBuilder.AddVertex(FDynamicMeshVertex(Center + AxisX * HalfTile + AxisY * HalfTile, FVector2D(1, 1), Color));
+			MeshBuilder.AddVertex(FDynamicMeshVertex(Center - AxisX * HalfTile + AxisY * HalfTile, FVector2D(0, 1), Color));
+			MeshBuilder.AddTriangle(First, First + 1, First + 2);
+			MeshBuilder.AddTriangle(First, First + 2, First + 3);
+		}
+		MeshBuilder.Draw(PDI, FMatrix::Identity, GEngine->VertexColorMaterial->GetRenderProxy(), SDPG_World, true, false);
+	}
+
+	if (bHasHover)
+	{
+		const float Radius = (BrushRadius + 0.5f) * GridActor->GetTileSizeHalf() * 2.0f;
+		// same colours as the overlay, red blocks and green clears
+		const FLinearColor BrushColor = bErasing ? FLinearColor::Green : FLinearColor::Red;
+		DrawCircle(PDI, HoverLocation + Up * 4.0f, AxisX, AxisY, BrushColor, Radius, 32, SDPG_Foreground);
+	}
+}
+
+void FFGGridPaintEdMode::DrawHUD(FEditorViewportClient* ViewportClient, FViewport* Viewport, const FSceneView* View, FCanvas* Canvas)
+{
+	FEdMode::DrawHUD(ViewportClient, Viewport, View, Canvas);
+
+	const FText Status = Grid.IsValid()
+		? FText::Format(LOCTEXT("BrushStatus", "Grid paint: radius {0}  ([ ] to resize, shift to erase)"), BrushRadius)
+		: LOCTEXT("NoGrid", "Grid paint: no grid in the level");
+
+	FCanvasTextItem Text(FVector2D(10.0f, 40.0f), Status, GEngine->GetSmallFont(), FLinearColor::White);
+	Text.EnableShadow(FLinearColor::Black);
+	Canvas->DrawItem(Text);
+}
+
+#undef LOCTEXT_NAMESPACE
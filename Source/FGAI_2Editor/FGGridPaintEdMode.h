@@ -0,0 +1,64 @@
+#pragma once
+
+#include "EdMode.h"
+
+class AFGGridActor;
+
+/*
+* Paints obstacles straight into a grid's imported layer instead of placing block components.
+* Left mouse paints, with shift it erases, [ and ] change the brush radius (in tiles).
+* Works on the selected grid, or the first one in the level when none is selected.
+*
+* Every stroke is one transaction. While it runs only the flipped tiles get patched into the grid, the block
+* mesh and jump data are rebuilt once when the mouse comes up. Until then the stroke's changes are drawn
+* as one batched overlay.
+*/
+class FFGGridPaintEdMode : public FEdMode
+{
+public:
+	static const FEditorModeID EM_GridPaint;
+
+	virtual void Enter() override;
+	virtual void Exit() override;
+
+	virtual bool InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event) override;
+	virtual bool InputDelta(FEditorViewportClient* InViewportClient, FViewport* InViewport, FVector& InDrag, FRotator& InRot, FVector& InScale) override;
+	virtual bool MouseMove(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 X, int32 Y) override;
+	virtual bool CapturedMouseMove(FEditorViewportClient* InViewportClient, FViewport* InViewport, int32 InMouseX, int32 InMouseY) override;
+
+	virtual void Render(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI) override;
+	virtual void DrawHUD(FEditorViewportClient* ViewportClient, FViewport* Viewport, const FSceneView* View, FCanvas* Canvas) override;
+
+	virtual bool AllowWidgetMove() override { return false; }
+	virtual bool ShouldDrawWidget() const override { return false; }
+	virtual bool UsesTransformWidget() const override { return false; }
+
+	int32 BrushRadius = 1;
+
+private:
+	AFGGridActor* FindGrid() const;
+
+	// grid tile under the mouse, false if the mouse isn't over the grid
+	bool UpdateHover(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 MouseX, int32 MouseY);
+
+	void BeginStroke();
+	void EndStroke();
+
+	// every tile of the brush on each tile from the last dab to the hovered one, so fast strokes don't leave gaps
+	void PaintToHover();
+
+	TWeakObjectPtr<AFGGridActor> Grid;
+
+	bool bHasHover = false;
+	FIntPoint HoverTile = FIntPoint::ZeroValue;
+	FVector HoverLocation = FVector::ZeroVector;
+
+	bool bPainting = false;
+	bool bErasing = false;
+	FIntPoint LastDabTile = FIntPoint::ZeroValue;
+
+	// tiles the current stroke flipped, what the overlay draws
+	TSet<int32> StrokeTiles;
+	TArray<int32> BrushTiles;
+	TArray<int32> ChangedTiles;
+};